@@ -0,0 +1,21 @@
+#ifdef MAIN_BOARD
+
+#include "Battery.h"
+
+/**
+ * Measure VDD against the internal reference.
+ *
+ * @return The supply voltage in mV, 0 if the ADC read nothing.
+ */
+uint16_t Battery::readMillivolts() {
+  analogReference(VDD);
+  VREF.CTRLA = (VREF.CTRLA & ~VREF_ADC0REFSEL_gm) | VREF_ADC0REFSEL_1V1_gc; // the reference being measured
+
+  analogRead(ADC_INTREF); // the first conversion after switching the reference is discarded
+  uint16_t reading = analogRead(ADC_INTREF);
+  if (reading == 0) return 0;
+
+  return (uint16_t) ((uint32_t) INTERNAL_REFERENCE_MV * 1023 / reading);
+}
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef TEMPERATURETRACKER_BATTERY_H
+#define TEMPERATURETRACKER_BATTERY_H
+
+#ifdef MAIN_BOARD
+
+#include "Arduino.h"
+
+/**
+ * Battery – supply voltage of the CR2032, measured by the ADC.
+ *
+ * The ADC uses VDD as its reference and converts the internal 1.1 V reference, so the reading shrinks as the
+ * supply rises and no pins or divider are needed.
+ */
+class Battery {
+public:
+    /** Supply voltage in mV, 0 if the measurement failed. */
+    static uint16_t readMillivolts();
+
+private:
+    constexpr static uint16_t INTERNAL_REFERENCE_MV = 1100;
+};
+
+#endif // MAIN_BOARD
+
+#endif //TEMPERATURETRACKER_BATTERY_H
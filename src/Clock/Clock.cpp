@@ -0,0 +1,100 @@
+#ifdef MAIN_BOARD
+
+#include "Clock.h"
+#include <avr/sleep.h>
+
+#if defined(BENCHMARK_BOARD) || defined(TRACE_ENABLED)
+#include "Timing/CycleTimer.h"
+#endif
+
+#if defined(MILLIS_USE_TIMERRTC) || defined(MILLIS_USE_TIMERRTC_XTAL)
+#error "Clock needs the RTC, select a different millis timer in the core options"
+#endif
+
+static uint16_t tickRemainder = 0; // 1024ths of a millisecond measured by earlier waits but not yet added to millis()
+
+ISR(RTC_CNT_vect) {
+  RTC.INTFLAGS = RTC_CMP_bm; // only wakes the CPU, idle() checks the count itself
+}
+
+/**
+ * The RTC count, starting the RTC on the 1.024 kHz ULP clock the first time.
+ *
+ * @return RTC ticks, wrapping at 2^16.
+ */
+uint16_t Clock::ticks() {
+  if (!(RTC.CTRLA & RTC_RTCEN_bm)) {
+    while (RTC.STATUS); // all of CTRLA, CNT, PER and CMP synchronise to the RTC clock
+    RTC.CLKSEL = RTC_CLKSEL_INT1K_gc;
+    RTC.PER = 0xFFFF;
+    RTC.CNT = 0;
+    while (RTC.STATUS);
+    RTC.CTRLA = RTC_PRESCALER_DIV1_gc | RTC_RTCEN_bm;
+    while (RTC.STATUS);
+  }
+  uint8_t sreg = SREG;
+  cli(); // a 16-bit register, read through the shared TEMP register
+  uint16_t count = RTC.CNT;
+  SREG = sreg;
+  return count;
+}
+
+/**
+ * Wait at CLK_PER / 64 in idle sleep, timed by the RTC.
+ *
+ * @param ms Milliseconds to wait, rounded up to whole RTC ticks. At most 60000, the RTC wraps after 64 s.
+ */
+void Clock::idle(uint16_t ms) {
+  if (ms == 0) return;
+  uint16_t length = (uint16_t) (((uint32_t) ms * TICKS_PER_SECOND + 999) / 1000);
+
+  uint8_t sreg = SREG;
+  cli();
+  uint32_t startMillis = millis();
+  uint16_t start = ticks();
+#if defined(BENCHMARK_BOARD) || defined(TRACE_ENABLED)
+  uint32_t startCycles = CycleTimer::now();
+#endif
+  SREG = sreg;
+
+  while (RTC.STATUS & RTC_CMPBUSY_bm);
+  RTC.CMP = start + length;
+  RTC.INTFLAGS = RTC_CMP_bm;
+  RTC.INTCTRL = RTC_CMP_bm;
+
+  uint8_t fullSpeed = CLKCTRL.MCLKCTRLB;
+  _PROTECTED_WRITE(CLKCTRL.MCLKCTRLB, CLKCTRL_PDIV_64X_gc | CLKCTRL_PEN_bm);
+
+  // the match only fires once CMP has synchronised, a couple of RTC clocks, which a short wait may already be past
+  while (RTC.STATUS & RTC_CMPBUSY_bm);
+
+  // the millis timer keeps waking the CPU (64 times less often), so go back to sleep until the time is up
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  sleep_enable();
+  cli();
+  while ((uint16_t) (RTC.CNT - start) < length) {
+    sei(); // the instruction after sei runs before any interrupt, so a match cannot slip in before the sleep
+    sleep_cpu();
+    cli();
+  }
+  sleep_disable();
+
+  _PROTECTED_WRITE(CLKCTRL.MCLKCTRLB, fullSpeed);
+  RTC.INTCTRL = 0;
+  uint16_t elapsed = RTC.CNT - start;
+
+  // the millis timer ran at 1/64 of its rate, so replace what it counted with the RTC's measure of the whole wait
+  uint32_t scaled = (uint32_t) elapsed * 1000 + tickRemainder;
+  tickRemainder = scaled % TICKS_PER_SECOND;
+  set_millis(startMillis + scaled / TICKS_PER_SECOND);
+
+#if defined(BENCHMARK_BOARD) || defined(TRACE_ENABLED)
+  // and so did TCB0, move it on to where it would be at full speed
+  uint32_t actual = (uint32_t) ((uint64_t) elapsed * F_CPU / TICKS_PER_SECOND);
+  uint32_t counted = CycleTimer::now() - startCycles;
+  if (actual > counted) CycleTimer::advance(actual - counted);
+#endif
+  SREG = sreg;
+}
+
+#endif
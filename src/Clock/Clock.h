@@ -0,0 +1,36 @@
+#ifndef TEMPERATURETRACKER_CLOCK_H
+#define TEMPERATURETRACKER_CLOCK_H
+
+#ifdef MAIN_BOARD
+
+#include "Arduino.h"
+
+/**
+ * Clock – runs the waits of a wake at a slow main clock.
+ *
+ * idle() replaces delay() for waits where the CPU has nothing to do (BME280 conversions, sensor start up, time
+ * between display frames). It divides CLK_PER by 64 and sleeps in idle mode until the RTC, which runs from the
+ * 32 kHz ULP oscillator and so is unaffected by the prescaler, says the time is up. The full speed prescaler is
+ * restored before it returns, so I2C, rendering and the compensation math always run at F_CPU.
+ *
+ * The RTC runs free from the first idle() on, so each wait is measured whole, including the register
+ * synchronisation and the wake up, and millis() and the CycleTimer behind the trace and benchmarks (whose timers
+ * run 64 times slower during the wait) are moved on by what it measured. That time is only as accurate as the ULP
+ * oscillator, see BenchmarkController::checkClock().
+ *
+ * Only call it between I2C transactions.
+ */
+class Clock {
+public:
+    static constexpr uint16_t TICKS_PER_SECOND = 1024; // of the RTC
+
+    /** Wait ms milliseconds at the slow clock, like delay(), to within an RTC tick. */
+    static void idle(uint16_t ms);
+
+    /** The free running RTC count, which wraps every 64 s. Starts the RTC if no idle() has yet. */
+    static uint16_t ticks();
+};
+
+#endif // MAIN_BOARD
+
+#endif //TEMPERATURETRACKER_CLOCK_H
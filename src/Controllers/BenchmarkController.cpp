@@ -0,0 +1,253 @@
+#ifdef BENCHMARK_BOARD
+
+#include "BenchmarkController.h"
+#include "Timing/CycleTimer.h"
+#include "Clock/Clock.h"
+
+volatile uint32_t benchSink; // results are written here so the compiler cannot drop the benchmarked work
+
+/**
+ * Setup function that brings up the hardware and runs the benchmarks once.
+ */
+void BenchmarkController::setup()
+{
+    // hold the power latch for the whole run
+    pinMode(POWER_CONTROL_PIN, OUTPUT);
+    digitalWrite(POWER_CONTROL_PIN, HIGH);
+
+    Serial.begin(SERIAL_BAUD);
+    sensor.setup();
+    display.setup();
+    logger.begin();
+    isolatedLogger.begin();
+    CycleTimer::begin();
+
+    runAll();
+
+    CycleTimer::end();
+    Serial.flush();
+}
+
+/**
+ * Check the clock once, then release the power latch. Kept out of setup() because it only means anything on the
+ * part: bench_host runs setup() alone, on a simulated clock.
+ */
+void BenchmarkController::loop()
+{
+    if (!clockChecked)
+    {
+        checkClock();
+        clockChecked = true;
+    }
+    digitalWrite(POWER_CONTROL_PIN, LOW);
+}
+
+/**
+ * Time `iterations` calls of `body` and print one result line.
+ *
+ * @param name       Name of the benchmark, stored in flash.
+ * @param iterations How many times to call the body.
+ * @param body       The code under test.
+ */
+template<typename F>
+void BenchmarkController::run(const __FlashStringHelper *name, uint16_t iterations, F body)
+{
+    uint32_t start = CycleTimer::now();
+    for (uint16_t i = 0; i < iterations; i++)
+    {
+        body(i);
+    }
+    uint32_t cycles = CycleTimer::now() - start;
+
+    Serial.print(F("BENCH,"));
+    Serial.print(name);
+    Serial.print(',');
+    Serial.print(iterations);
+    Serial.print(',');
+    Serial.print(cycles);
+    Serial.print(',');
+    Serial.println(cycles / iterations);
+}
+
+/**
+ * Time eight pushes of fixed samples, then print the time they spent in EEPROM writes.
+ *
+ * @param name   Name of the benchmark, stored in flash.
+ * @param target The logger to push to.
+ */
+template<typename L>
+void BenchmarkController::runPush(const __FlashStringHelper *name, L &target)
+{
+    const uint16_t pushes = 8;
+    uint32_t commitMicros = 0;
+    run(name, pushes, [&target, &commitMicros](uint16_t i) {
+        target.push(15.0f + i, 40.0f + i);
+        commitMicros += target.lastCommitMicros();
+    });
+
+    Serial.print(F("COMMIT,"));
+    Serial.print(name);
+    Serial.print(',');
+    Serial.print(pushes);
+    Serial.print(',');
+    Serial.print(commitMicros);
+    Serial.print(',');
+    Serial.println(commitMicros / pushes);
+}
+
+/**
+ * Run every benchmark once. Inputs are fixed so runs on different builds are comparable.
+ */
+void BenchmarkController::runAll()
+{
+    Serial.print(F("BENCH_BEGIN,"));
+    Serial.println(F_CPU);
+
+    // cost of the harness itself, subtract it from the very short benchmarks
+    run(F("overhead"), 100, [](uint16_t i) { benchSink = i; });
+
+    // sensor
+    run(F("sensor_read"), 4, [this](uint16_t) {
+        Sensor::Data data = sensor.readData();
+        benchSink = (uint32_t) data.temperature;
+    });
+    run(F("compensate_temperature"), 100, [this](uint16_t i) {
+        benchSink = sensor.compensateTemperature(519888 + i * 16);
+    });
+    run(F("compensate_humidity"), 100, [this](uint16_t i) {
+        benchSink = sensor.compensateHumidity(28000 + i * 16);
+    });
+    run(F("sensor_convert"), 100, [this](uint16_t i) {
+        const uint8_t data[8] = {0x80, 0, 0, 0x7E, (uint8_t) i, 0, 0x6D, (uint8_t) i};
+        benchSink = (uint32_t) sensor.convert(data).humidity;
+    });
+    run(F("sensor_calibration_isolated"), 100, [this](uint16_t) {
+        isolatedSensor.readCalibrationData();
+    });
+
+    // logger (EEPROM): a push is one page write, against the byte at a time writes it replaced
+    static uint8_t saved[LoggerCodec::HISTORY_PAGES][LoggerCodec::PAGE_SIZE];
+    for (uint8_t page = 0; page < LoggerCodec::HISTORY_PAGES; page++)
+    {
+        for (uint8_t i = 0; i < LoggerCodec::PAGE_SIZE; i++)
+        {
+            saved[page][i] = EepromStorage::read(page * LoggerCodec::PAGE_SIZE + i);
+        }
+    }
+    runPush(F("logger_push"), logger);
+    runPush(F("logger_push_bytes"), byteLogger);
+    static float history[Logger::NUM_SAMPLES];
+    run(F("logger_read_temperature"), 20, [this](uint16_t) {
+        logger.readTemperature(history);
+    });
+    run(F("logger_push_isolated"), 100, [this](uint16_t i) {
+        isolatedLogger.push(15.0f + i, 40.0f + i);
+    });
+    run(F("logger_read_temperature_isolated"), 20, [this](uint16_t) {
+        isolatedLogger.readTemperature(history);
+    });
+
+    // display
+    run(F("formatted_temp_string"), 100, [this](uint16_t i) {
+        benchSink = (uint32_t) display.formattedTempString(-20.0f + i * 0.37f)[0];
+    });
+    run(F("draw_string_scale"), 20, [this](uint16_t) {
+        display.drawStringScale(12, 0, "23.45d", 4);
+    });
+    run(F("display_main_frame"), 10, [this](uint16_t i) {
+        display.displayMain(21.5f + i, 45.0f + i);
+    });
+    run(F("display_chart_frame"), 10, [this](uint16_t) {
+        display.displayChart(logger, LoggerCodec::TEMPERATURE);
+    });
+    run(F("display_main_frame_isolated"), 10, [this](uint16_t i) {
+        isolatedDisplay.displayMain(21.5f + i, 45.0f + i);
+    });
+    run(F("display_chart_frame_isolated"), 10, [this](uint16_t) {
+        isolatedDisplay.displayChart(isolatedLogger, LoggerCodec::TEMPERATURE);
+    });
+
+    // the real history back, as it was before logger_push
+    for (uint8_t page = 0; page < LoggerCodec::HISTORY_PAGES; page++)
+    {
+        EepromStorage::updatePage(page * LoggerCodec::PAGE_SIZE, saved[page]);
+    }
+
+    Serial.println(F("BENCH_END"));
+}
+
+/**
+ * Check Clock::idle() against time bases it does not set, for tools/clock_check.py:
+ *   "CLOCK,ulp,<RTC ticks>,<TCB0 cycles>"  a second of busy waiting at full speed, the ULP oscillator against the
+ *                                         main one
+ *   "CLOCK,idle,<ms>,<millis delta>,<RTC ticks>,<TCB0 cycles>"  a wait of known length
+ *   "CLOCK,debounce,<interval>,<idles>,<millis delta>,<RTC ticks>"  the loop() idles before the button debounce
+ *                                         interval is over
+ * The RTC ticks are read here, around the wait, and TCB0 counts at full speed outside it. Each line is sent right
+ * after its wait, so a capture with host timestamps (`pio device monitor --filter time`) also shows how long it took.
+ */
+void BenchmarkController::checkClock()
+{
+    static const uint16_t lengths[] = {2, 10, 250, 1000, 5000};
+
+    Serial.print(F("CLOCK_BEGIN,"));
+    Serial.println(F_CPU);
+    Serial.flush(); // the UART runs from CLK_PER too, so nothing may be sending while it is slow
+    CycleTimer::begin();
+
+    uint16_t ticks = Clock::ticks();
+    uint32_t cycles = CycleTimer::now();
+    delay(1000);
+    ticks = Clock::ticks() - ticks;
+    cycles = CycleTimer::now() - cycles;
+    Serial.print(F("CLOCK,ulp,"));
+    Serial.print(ticks);
+    Serial.print(',');
+    Serial.println(cycles);
+
+    for (uint16_t ms : lengths)
+    {
+        Serial.flush();
+        unsigned long start = millis();
+        ticks = Clock::ticks();
+        cycles = CycleTimer::now();
+        Clock::idle(ms);
+        unsigned long elapsed = millis() - start;
+        ticks = Clock::ticks() - ticks;
+        cycles = CycleTimer::now() - cycles;
+
+        Serial.print(F("CLOCK,idle,"));
+        Serial.print(ms);
+        Serial.print(',');
+        Serial.print(elapsed);
+        Serial.print(',');
+        Serial.print(ticks);
+        Serial.print(',');
+        Serial.println(cycles);
+    }
+
+    Serial.flush();
+    unsigned long pressed = millis();
+    ticks = Clock::ticks();
+    uint16_t idles = 0;
+    while (millis() - pressed <= BUTTON_DEBOUNCE_INTERVAL) // the same test MainController::loop() makes
+    {
+        Clock::idle(LOOP_IDLE_TIME);
+        idles++;
+    }
+    unsigned long elapsed = millis() - pressed;
+    ticks = Clock::ticks() - ticks;
+    CycleTimer::end();
+
+    Serial.print(F("CLOCK,debounce,"));
+    Serial.print(BUTTON_DEBOUNCE_INTERVAL);
+    Serial.print(',');
+    Serial.print(idles);
+    Serial.print(',');
+    Serial.print(elapsed);
+    Serial.print(',');
+    Serial.println(ticks);
+    Serial.println(F("CLOCK_END"));
+}
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef TEMPERATURETRACKER_BENCHMARKCONTROLLER_H
+#define TEMPERATURETRACKER_BENCHMARKCONTROLLER_H
+
+#ifdef BENCHMARK_BOARD
+
+#include "Arduino.h"
+#include "Display/Display.h"
+#include "Sensor/Sensor.h"
+#include "Logger/Logger.h"
+#include "Hal/Isolation.h"
+
+/**
+ * Runs microbenchmarks of the firmware hot paths on the real hardware and streams the results over the UART.
+ *
+ * Each result is one line: "BENCH,<name>,<iterations>,<total cycles>,<cycles per iteration>", framed by
+ * "BENCH_BEGIN,<F_CPU>" and "BENCH_END". tools/bench_diff.py parses and compares runs. The logger_push results are
+ * each followed by "COMMIT,<name>,<pushes>,<total us>,<us per push>", the time the pushes spent writing the EEPROM
+ * (Logger::lastCommitMicros), which the cycle counts include but do not separate. A check of Clock::idle()
+ * follows from loop(), between "CLOCK_BEGIN,<F_CPU>" and "CLOCK_END", for tools/clock_check.py.
+ */
+class BenchmarkController {
+public:
+    void setup();
+
+    void loop();
+
+private:
+    constexpr static byte POWER_CONTROL_PIN = 2; // pin for the power latch control pin (same as MainController)
+    constexpr static unsigned long SERIAL_BAUD = 115200; // baud rate of the results stream
+    constexpr static unsigned long BUTTON_DEBOUNCE_INTERVAL = 500; // same as MainController
+    constexpr static uint16_t LOOP_IDLE_TIME = 10; // same as MainController
+
+    Sensor sensor; // object to read the sensor data (temp and humidity)
+    Display display; // object to handle the display
+    Logger logger; // the real history, saved before the logger benchmarks and written back after them
+    LoggerT<ByteEepromStorage> byteLogger; // the same history a byte per erase/write, the baseline of logger_push
+    bool clockChecked = false; // checkClock() has run
+
+    // the same modules on stand-in peripherals (Hal/Isolation.h), timing their own code without the bus, NVM or panel
+    SensorT<RegisterBus> isolatedSensor;
+    LoggerT<RamStorage> isolatedLogger;
+    DisplayT<NullPanel> isolatedDisplay;
+
+    template<typename F>
+    void run(const __FlashStringHelper *name, uint16_t iterations, F body); // time and report one benchmark
+
+    template<typename L>
+    void runPush(const __FlashStringHelper *name, L &target); // time 8 pushes and report their EEPROM write time
+
+    void runAll(); // run every benchmark once
+
+    void checkClock(); // report Clock::idle() waits of known length against the RTC and TCB0
+};
+
+#endif
+#endif //TEMPERATURETRACKER_BENCHMARKCONTROLLER_H
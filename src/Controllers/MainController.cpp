@@ -6,12 +6,20 @@
 #include "MainController.h"
 #include <avr/wdt.h>
 #include <avr/sleep.h> // <-- REQUIRED for safe power down
+#include "Trace/Trace.h"
+#include "Telemetry/Telemetry.h"
+#include "Export/Exporter.h"
+#include "Battery/Battery.h"
+#include "Clock/Clock.h"
 
 /**
  * Setup function to initialize the main controller.
  */
 void MainController::setup()
 {
+    TRACE_BEGIN();
+    TRACE(TRACE_SETUP_BEGIN);
+
     // first turn on the power latch
     pinMode(POWER_CONTROL_PIN, OUTPUT);
     digitalWrite(POWER_CONTROL_PIN, HIGH);
@@ -53,29 +61,105 @@ void MainController::setup()
         measurementState = MEASURE_ON_START; // if the measurement pin is high, we have a measurement to process
     }
 
-    // set up other components
-    sensor.setup();
-    display.setup();
+    // measure the battery before anything else loads the rail, it decides how the rest of the wake runs
+    applyPowerPolicy();
+
     logger.begin();
-    wdt_reset();
 
-    // Query the EEPROM reset pin to see if we need to reset the EEPROM
+    // Query the EEPROM reset pin to see if we need to reset the EEPROM, before anything shows what it holds
     pinMode(EEPROM_RESET_PIN, INPUT_PULLUP);
-    if (digitalRead(EEPROM_RESET_PIN) == LOW)
+    bool eepromReset = digitalRead(EEPROM_RESET_PIN) == LOW;
+    if (eepromReset)
     {
         logger.resetEEMPROM(20, 30); // if the reset pin is low, reset the EEPROM to arbitrary values
     }
 
+    if (measurementState != MEASURE_ON_START)
+    {
+        // bring the panel up first on a button wake, showing the last logged sample while the sensors start. After a
+        // reset the log only holds the placeholder values, so the panel stays blank until the live reading instead.
+        display.setup();
+        if (!eepromReset) showLastSample();
+    }
+
+    // set up other components, both sensors together if the probe is plugged in
+    Sensor *sensors[] = {&sensor, &probe};
+    probeAttached = Sensor::setupAll(sensors, 2, 1) == 2;
+    if (measurementState == MEASURE_ON_START) display.setup(); // as late as possible, nothing is shown
+    wdt_reset();
+
     if (measurementState == MEASURE_ON_START)
     {
-        delay(250); // delay a bit to allow the sensor to stabilize
+        Clock::idle(250); // delay a bit to allow the sensor to stabilize
         takeMeasurement();
-        delay(500);
-        powerOff(); // turn off the power latch after taking the measurement
-        while (1) powerOff(); // The forever loop makes sure it doesn't go into the main loop
+        Clock::idle(500);
+        powerOff(); // turn off the power latch after taking the measurement, never returns to the main loop
     }
 
+    // holding the button through boot switches to exporting the logged data over the UART
+    while (digitalRead(PUSH_BUTTON_PIN) == HIGH)
+    {
+        wdt_reset();
+        if (millis() > EXPORT_HOLD_TIME)
+        {
+            exportData();
+        }
+        delay(10);
+    }
+
+    // swap the live reading in over the stale one, only the tiles that changed are sent
+    updateDisplay();
+    lastDisplayUpdate = millis();
+
     lastActivity = millis(); // set the last activity time to now
+    TRACE(TRACE_SETUP_END);
+}
+
+/**
+ * Measure the battery and degrade the display refresh, power off timeout and sensor configuration as it runs down.
+ */
+void MainController::applyPowerPolicy()
+{
+    batteryMillivolts = Battery::readMillivolts();
+
+    BatteryLevel level = BATTERY_NORMAL;
+    if (batteryMillivolts != 0 && batteryMillivolts < CRITICAL_BATTERY_MV) level = BATTERY_CRITICAL;
+    else if (batteryMillivolts != 0 && batteryMillivolts < LOW_BATTERY_MV) level = BATTERY_LOW;
+
+    if (level == BATTERY_CRITICAL)
+    {
+        displayUpdateInterval = CRITICAL_DISPLAY_UPDATE_INTERVAL;
+        powerOffTimeout = CRITICAL_POWER_OFF_TIMEOUT;
+    }
+    else if (level == BATTERY_LOW)
+    {
+        displayUpdateInterval = LOW_DISPLAY_UPDATE_INTERVAL;
+        powerOffTimeout = LOW_POWER_OFF_TIMEOUT;
+    }
+    // indoor trades about 4.6 uAs a reading for steadier chart cells than the ×1, unfiltered ultra-low-power
+    Sensor::Profile profile = level == BATTERY_NORMAL ? Sensor::PROFILE_INDOOR : Sensor::PROFILE_ULTRA_LOW_POWER;
+    sensor.setProfile(profile);
+    probe.setProfile(profile);
+}
+
+/**
+ * Draw the newest logged sample on the main screen, marked as stale. Nothing is drawn if the log is empty.
+ */
+void MainController::showLastSample()
+{
+    float temperature, humidity;
+    if (logger.latest(temperature, humidity)) display.displayMain(temperature, humidity, true);
+}
+
+/**
+ * Stream the EEPROM and sensor calibration to a host (see Exporter), then power off.
+ */
+void MainController::exportData()
+{
+    display.powerDown();
+    Exporter exporter(sensor);
+    exporter.run();
+    powerOff();
 }
 
 /**
@@ -84,7 +168,7 @@ void MainController::setup()
 void MainController::loop()
 {
     wdt_reset();
-    if (millis() - lastActivity > POWER_OFF_TIMEOUT)
+    if (millis() - lastActivity > powerOffTimeout)
     {
         powerOff(); // if the user has not interacted for a while, power off
     }
@@ -93,15 +177,17 @@ void MainController::loop()
         millis() - lastButtonPress > BUTTON_DEBOUNCE_INTERVAL &&
         millis() > 1500 /* Don't switch in the first 1.5s to prevent accidentally going too far on start */)
     {
+        TRACE(TRACE_LOOP_BUTTON);
         lastButtonPress = millis();
         lastActivity = millis();
         currentScreen = static_cast<ScreenState>((currentScreen + 1) % 3); // cycle through the 3 screens
         updateDisplay(); // force a displayUpdate
     }
 
-    if (millis() - lastDisplayUpdate > DISPLAY_UPDATE_INTERVAL)
+    if (millis() - lastDisplayUpdate > displayUpdateInterval)
     {
         // update the display based on the current screen state
+        TRACE(TRACE_LOOP_DISPLAY_UPDATE);
         lastDisplayUpdate = millis();
         updateDisplay();
     }
@@ -113,6 +199,9 @@ void MainController::loop()
         measurementState = MEASURE_IN_MAIN; // set the measurement state to indicate a measurement was taken
         takeMeasurement(); // take a measurement from the sensor
     }
+
+    // nothing to do until the next frame or input, so wait at the slow clock instead of spinning
+    Clock::idle(LOOP_IDLE_TIME);
 }
 
 /**
@@ -128,27 +217,56 @@ void MainController::updateDisplay()
     }
     else if (currentScreen == TEMP_GRAPH)
     {
-        // Show the temperature graph
-        static float temperatureHistory[28];
-        logger.readTemperature(temperatureHistory);
-        display.displayChart(temperatureHistory, true);
+        // Show the temperature graph, drawn straight from the EEPROM history
+        display.displayChart(logger, LoggerCodec::TEMPERATURE);
     }
     else if (currentScreen == HUMIDITY_GRAPH)
     {
         // Show the humidity graph
-        static float humidityHistory[28];
-        logger.readHumidity(humidityHistory);
-        display.displayChart(humidityHistory, false);
+        display.displayChart(logger, LoggerCodec::HUMIDITY);
     }
 }
 
 /**
  * Function to power off the device by turning off the power latch.
+ *
+ * The latch supply does not collapse instantly, so everything on the rail is shut down first. Otherwise the OLED
+ * charge pump (~5-15 mA depending on lit pixels) and an awake MCU (~3 mA) keep drawing from the coin cell until the
+ * rail decays. After this sequence the tail is the BME280 in sleep (~0.1 uA), the SSD1306 in sleep (<10 uA) and the
+ * MCU in power down (~0.1 uA). Figures are datasheet typicals at 3 V.
  */
 void MainController::powerOff()
 {
+    TRACE(TRACE_POWER_OFF);
+    TRACE_FLUSH(); // optional trace summary to EEPROM, finished by the busy wait below
+    Telemetry::commit(measurementState == MEASURE_ON_START, millis()); // once per wake, alongside the log
+
+    // 1. let the last EEPROM erase/write cycle finish so the log is never left half written
+    while (NVMCTRL.STATUS & NVMCTRL_EEBUSY_bm);
+
+    // 2. put the BME280s into sleep mode
+    sensor.powerOff();
+    if (probeAttached) probe.powerOff();
+
+    // 3. turn off the SSD1306 panel and its charge pump
+    display.powerDown();
+
+    // 4. release the I2C bus and tri-state its pins so nothing is driven into the decaying rail
+    WireBus::end();
+    pinMode(PIN_WIRE_SDA, INPUT);
+    pinMode(PIN_WIRE_SCL, INPUT);
+
+    // 5. release the power latch
     delay(10);
     digitalWrite(POWER_CONTROL_PIN, LOW);
+
+    // Nothing left to do, so sleep through the decay instead of spinning. Interrupts are off so only the rail
+    // collapsing (or the watchdog, which takes the crash path in setup()) ends this; the loop only puts the core
+    // back to sleep should an enabled interrupt source wake it anyway.
+    cli();
+    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+    sleep_enable();
+    while (true) sleep_cpu();
 }
 
 /**
@@ -156,8 +274,16 @@ void MainController::powerOff()
  */
 void MainController::takeMeasurement()
 {
-    Sensor::Data sensorData = sensor.readData(); // read the sensor data
-    logger.push(sensorData.temperature, sensorData.humidity); // write the measurement to the logger
+    TRACE(TRACE_MEASUREMENT_BEGIN);
+    // read both sensors in the time of one conversion
+    Sensor *sensors[] = {&sensor, &probe};
+    Sensor::Data sensorData[2];
+    Sensor::readAll(sensors, sensorData, probeAttached ? 2 : 1);
+
+    // write the measurement to the logger, the probe's cells are left empty without one
+    logger.push(sensorData[0].temperature, sensorData[0].humidity, batteryMillivolts,
+                probeAttached ? sensorData[1].temperature : NAN, probeAttached ? sensorData[1].humidity : NAN);
+    TRACE(TRACE_MEASUREMENT_END);
 }
 
 #endif
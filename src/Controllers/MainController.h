@@ -7,17 +7,16 @@
 
 #ifdef MAIN_BOARD
 
-#include "Controller.h"
 #include "Arduino.h"
 #include "Display/Display.h"
 #include "Sensor/Sensor.h"
 #include "Logger/Logger.h"
 
-class MainController : public Controller {
+class MainController {
 public:
-    void setup() override;
+    void setup();
 
-    void loop() override;
+    void loop();
 
 private:
     constexpr static byte PUSH_BUTTON_PIN = 0; // pin for the push button
@@ -27,17 +26,36 @@ private:
 
     constexpr static unsigned long DISPLAY_UPDATE_INTERVAL = 250; // interval to update the display in ms
     constexpr static unsigned long POWER_OFF_TIMEOUT = 1000 * 10; // time in ms to shut off after last interaction
+    constexpr static unsigned long LOW_DISPLAY_UPDATE_INTERVAL = 1000; // display interval on a low battery
+    constexpr static unsigned long LOW_POWER_OFF_TIMEOUT = 1000 * 6; // power off timeout on a low battery
+    constexpr static unsigned long CRITICAL_DISPLAY_UPDATE_INTERVAL = 2000; // display interval on a flat battery
+    constexpr static unsigned long CRITICAL_POWER_OFF_TIMEOUT = 1000 * 4; // power off timeout on a flat battery
+    constexpr static uint16_t LOW_BATTERY_MV = 2800; // CR2032 is past the knee of its discharge curve below this
+    constexpr static uint16_t CRITICAL_BATTERY_MV = 2500; // a few weeks left, the SSD1306 may brown out below
     constexpr static unsigned long BUTTON_DEBOUNCE_INTERVAL = 500; // interval to write to EEPROM in ms
+    constexpr static unsigned long EXPORT_HOLD_TIME = 3000; // ms the button is held from boot to enter export mode
+    constexpr static uint16_t LOOP_IDLE_TIME = 10; // ms each loop() idles at the slow clock, well under a button press
 
 
     Sensor sensor; // object to read the sensor data (temp and humidity)
+    Sensor probe = Sensor(BME280_ADDR_PROBE); // optional second sensor on the external lead
+    bool probeAttached = false; // whether the probe answered this wake
     Display display; // object to handle the display
-    Logger logger = Logger(0); // object to read / write EEPROM
+    Logger logger; // object to read / write EEPROM
 
     unsigned long lastActivity = 0; // last time the user interacted with the device (used for powering off)
     unsigned long lastDisplayUpdate = 0; // last time the display was updated
     unsigned long lastButtonPress = 0; // last time the button was pressed (used for debouncing)
 
+    enum BatteryLevel : uint8_t {
+        BATTERY_NORMAL,
+        BATTERY_LOW,
+        BATTERY_CRITICAL
+    };
+    uint16_t batteryMillivolts = 0; // supply voltage measured at wake, 0 if unknown
+    unsigned long displayUpdateInterval = DISPLAY_UPDATE_INTERVAL; // display interval for the battery level
+    unsigned long powerOffTimeout = POWER_OFF_TIMEOUT; // power off timeout for the battery level
+
     enum MeasurementState {
         NO_MEASUREMENT, // No measurement taken yet
         MEASURE_ON_START, // Measurement taken on wakeup then going back to power off
@@ -53,11 +71,17 @@ private:
     };
     ScreenState currentScreen = MAIN_SCREEN; // current screen state
 
-    void powerOff(); // function to power off the device
+    [[noreturn]] void powerOff(); // function to power off the device
+
+    void applyPowerPolicy(); // measure the battery and pick the display / sampling settings for it
 
     void updateDisplay(); // function to update the display based on the current screen state
 
+    void showLastSample(); // show the last logged sample, marked stale, until the sensor has a reading
+
     void takeMeasurement(); // function to take a measurement from the sensor
+
+    [[noreturn]] void exportData(); // function to stream the logged data over the UART
 };
 
 #endif
@@ -7,90 +7,96 @@
 #include "Display.h"
 #include "math.h"
 #include "string.h"
+#include "Trace/Trace.h"
+#include "Telemetry/Telemetry.h"
+#include "Hal/Isolation.h"
+#include "Logger/Logger.h"
+
+// Font tables, generated by the compiler from FontTables.h. The definitions are constexpr so an initializer that
+// stops being a constant expression fails the build instead of turning into start-up code writing to flash
+constexpr Font::Table<uint8_t, Font::GLYPHS * Font::WIDTH> DisplayBase::glyphColumns PROGMEM = Font::columnTable();
+constexpr Font::Table<uint8_t, Font::CHAR_TABLE_SIZE> DisplayBase::charTable PROGMEM = Font::charTable();
+constexpr Font::Table<uint8_t, Font::GLYPHS * Font::HEIGHT> DisplayBase::glyphXbm PROGMEM = Font::xbmTable();
+constexpr Font::Table<uint8_t, 16> DisplayBase::spread2 PROGMEM = Font::spreadTable<2>();
+constexpr Font::Table<uint8_t, 4> DisplayBase::spread4 PROGMEM = Font::spreadTable<4>();
+
+// Chart labels as glyph indices
+constexpr Font::GlyphString<4> DisplayBase::tempTitle PROGMEM = Font::glyphs("TEMP");
+constexpr Font::GlyphString<5> DisplayBase::humidTitle PROGMEM = Font::glyphs("HUMID");
+constexpr Font::GlyphString<2> DisplayBase::weekLabel PROGMEM = Font::glyphs("7D");
+
+// Maps a character to its index in the font tables
+uint8_t DisplayBase::charIndex(char c) {
+  if (c < Font::FIRST_CHAR || c > Font::LAST_CHAR) return Font::NONE;
+  return pgm_read_byte(&charTable.v[c - Font::FIRST_CHAR]);
+}
 
-// Initialize U8G2 library for 128x64 I2C OLED (no reset pin used)
-U8G2_SSD1306_128X64_NONAME_1_HW_I2C Display::u8g2 = U8G2_SSD1306_128X64_NONAME_1_HW_I2C(U8G2_R0, U8X8_PIN_NONE);
-
-// Font bitmap definitions for custom characters 6x8 pixels
-const uint8_t Display::font6x8_digits[][6] PROGMEM = {
-        // Each entry represents 1 character using 6 bytes (columns)
-        // Digits 0–9
-        {0x3E, 0x51, 0x49, 0x45, 0x3E, 0x00},  // 0
-        {0x00, 0x42, 0x7F, 0x40, 0x00, 0x00},  // 1
-        {0x42, 0x61, 0x51, 0x49, 0x46, 0x00},  // 2
-        {0x21, 0x41, 0x45, 0x4B, 0x31, 0x00},  // 3
-        {0x18, 0x14, 0x12, 0x7F, 0x10, 0x00},  // 4
-        {0x27, 0x45, 0x45, 0x45, 0x39, 0x00},  // 5
-        {0x3C, 0x4A, 0x49, 0x49, 0x30, 0x00},  // 6
-        {0x01, 0x71, 0x09, 0x05, 0x03, 0x00},  // 7
-        {0x36, 0x49, 0x49, 0x49, 0x36, 0x00},  // 8
-        {0x06, 0x49, 0x49, 0x29, 0x1E, 0x00},  // 9
-
-        // Special characters: . d % -
-        {0x00, 0x00, 0x60, 0x60, 0x00, 0x00},  // .
-        {0x06, 0x09, 0x09, 0x06, 0x00, 0x00},  // d (degree)
-        {0x62, 0x64, 0x08, 0x13, 0x23, 0x00},  // %
-        {0x08, 0x08, 0x08, 0x08, 0x08, 0x00},  // -
-
-        // Letters used for labels
-        {0x01, 0x01, 0x7F, 0x01, 0x01, 0x00},  // T
-        {0x7F, 0x08, 0x08, 0x08, 0x7F, 0x00},  // H
-        {0x7F, 0x49, 0x49, 0x49, 0x41, 0x00},  // E
-        {0x7F, 0x02, 0x04, 0x02, 0x7F, 0x00},  // M
-        {0x7F, 0x09, 0x09, 0x09, 0x06, 0x00},  // P
-        {0x3F, 0x40, 0x40, 0x40, 0x3F, 0x00},  // U
-        {0x00, 0x41, 0x7F, 0x41, 0x00, 0x00},  // I
-        {0x7F, 0x41, 0x41, 0x22, 0x1C, 0x00},  // D
-};
-
-// Maps a character to its index in the font array
-uint8_t Display::charIndex(char c) {
-  if (c >= '0' && c <= '9') return c - '0';
-  if (c == '.') return 10;
-  if (c == 'd') return 11;
-  if (c == '%') return 12;
-  if (c == '-') return 13;
-  if (c == 'T') return 14;
-  if (c == 'H') return 15;
-  if (c == 'E') return 16;
-  if (c == 'M') return 17;
-  if (c == 'P') return 18;
-  if (c == 'U') return 19;
-  if (c == 'I') return 20;
-  if (c == 'D') return 21;
-
-  return 0xFF; // not found
+// One 8-pixel column of a glyph, bit 0 at the top, 0 for Font::NONE
+uint8_t DisplayBase::glyphColumn(uint8_t glyph, uint8_t col) {
+  if (glyph == Font::NONE) return 0;
+  return pgm_read_byte(&glyphColumns.v[glyph * Font::WIDTH + col]);
 }
 
-// Draw a single character scaled by `scale` factor at (x0, y0)
-void Display::drawCharScale(uint8_t x0, uint8_t y0, char c, const int scale) {
-  uint8_t idx = charIndex(c);
-  if (idx == 0xFF) return; // ignore unknown characters
-  for (uint8_t col = 0; col < 6; col++) {
-    uint8_t bits = pgm_read_byte(&font6x8_digits[idx][col]);
-    for (uint8_t row = 0; row < 8; row++) {
-      if (c == ' ') continue; // skip spaces
-      if (bits & (1 << row)) {
-        // draw each "on" pixel as a box of (scale x scale) size
-        u8g2.drawBox(
-                x0 + col * scale,
-                y0 + row * scale,
-                scale, scale
-        );
+// Draw a single glyph scaled by `scale` factor at (x0, y0)
+template<typename PanelT>
+void DisplayT<PanelT>::drawGlyphScale(uint8_t x0, uint8_t y0, uint8_t glyph, uint8_t scale) {
+  if (glyph == Font::NONE) return; // ignore unknown characters and spaces
+  if (scale == 1) {
+    PanelT::drawXBMP(x0, y0, Font::WIDTH, Font::HEIGHT, &glyphXbm.v[glyph * Font::HEIGHT]);
+    return;
+  }
+
+  uint8_t col = 0;
+  while (col < Font::WIDTH) {
+    uint8_t bits = glyphColumn(glyph, col);
+    // identical neighbouring columns share their boxes
+    uint8_t width = 1;
+    while (col + width < Font::WIDTH && glyphColumn(glyph, col + width) == bits) width++;
+
+    // one box per vertical run of "on" pixels
+    uint8_t row = 0;
+    while (bits) {
+      if (!(bits & 1)) {
+        bits >>= 1;
+        row++;
+        continue;
       }
+      uint8_t first = row;
+      while (bits & 1) {
+        bits >>= 1;
+        row++;
+      }
+      PanelT::drawBox(x0 + col * scale, y0 + first * scale, width * scale, (row - first) * scale);
     }
+    col += width;
   }
 }
 
+// Draw a single character scaled by `scale` factor at (x0, y0)
+template<typename PanelT>
+void DisplayT<PanelT>::drawCharScale(uint8_t x0, uint8_t y0, char c, const int scale) {
+  drawGlyphScale(x0, y0, charIndex(c), scale);
+}
+
 // Draw a scaled string starting at (x, y)
-void Display::drawStringScale(uint8_t x, uint8_t y, const char *s, const int scale) {
+template<typename PanelT>
+void DisplayT<PanelT>::drawStringScale(uint8_t x, uint8_t y, const char *s, const int scale) {
   while (*s) {
     drawCharScale(x, y, *s++, scale);
     x += 6 * scale; // move cursor right by width of character
   }
 }
 
-const char *Display::formattedTempString(float temperature) {
+// Draw `count` glyph indices from PROGMEM at scale 1 starting at (x, y)
+template<typename PanelT>
+void DisplayT<PanelT>::drawGlyphs(uint8_t x, uint8_t y, const uint8_t *glyphs, uint8_t count) {
+  for (uint8_t i = 0; i < count; i++) {
+    drawGlyphScale(x, y, pgm_read_byte(&glyphs[i]), 1);
+    x += Font::WIDTH;
+  }
+}
+
+const char *DisplayBase::formattedTempString(float temperature) {
   /**
    * Formats a temperature float into a 5-character string (e.g., "25.6d" or "-5.5d").
    *
@@ -166,7 +172,7 @@ const char *Display::formattedTempString(float temperature) {
   return result;
 }
 
-char *Display::formattedHumString(float humidity) {
+char *DisplayBase::formattedHumString(float humidity) {
   /**
    * Formats humidity (0–100) into a 5-character string like "55.0%".
    *
@@ -212,13 +218,16 @@ char *Display::formattedHumString(float humidity) {
   return result;
 }
 
-void Display::setup() {
+template<typename PanelT>
+void DisplayT<PanelT>::setup() {
   // Initialize the display
-  u8g2.setI2CAddress(0x7A);
-  u8g2.begin();
+  PanelT::begin(); // transparent bitmap mode, so scale 1 glyphs draw only their "on" pixels like the boxes do
+  mainShown = false;
 }
 
-void Display::displayMain(float temperature, float humidity) {
+template<typename PanelT>
+void DisplayT<PanelT>::displayMain(float temperature, float humidity, bool stale) {
+  TRACE(TRACE_DISPLAY_MAIN_BEGIN);
   // FIXED: Using Page Buffer Loop for low memory
 
   // Pre-calculate strings to save processing inside the loop
@@ -227,71 +236,180 @@ void Display::displayMain(float temperature, float humidity) {
   strcpy(tempStr, formattedTempString(temperature));
   strcpy(humStr, formattedHumString(humidity));
 
-  u8g2.firstPage();
-  do {
+  if (mainShown) {
+    // Fast path: only rewrite the 8x8 tiles under characters that changed, and the labels if the marker did
+    uint16_t labels = stale != shownStale ? STALE_TILES : 0;
+    shownStale = stale;
+    drawMainTiles(changedTiles(shownTemp, tempStr) | labels, 0, 3);
+    drawMainTiles(changedTiles(shownHum, humStr) | labels, 4, 7);
+    Telemetry::countFrame();
+    TRACE(TRACE_DISPLAY_MAIN_END);
+    return;
+  }
+
+  PanelT::render([&]() {
       // T: temperature
-      drawCharScale(0, 0, 'T', 2);
-      drawStringScale(12, 0, tempStr, 4);
+      drawGlyphScale(0, 0, TEMP_LABEL, 2);
+      drawStringScale(MAIN_TEXT_X, 0, tempStr, 4);
 
       // H: humidity
-      drawCharScale(0, 36, 'H', 2);
-      drawStringScale(12, 36, humStr, 4);
-  } while (u8g2.nextPage());
+      drawGlyphScale(0, MAIN_HUM_Y, HUM_LABEL, 2);
+      drawStringScale(MAIN_TEXT_X, MAIN_HUM_Y, humStr, 4);
+
+      if (stale) {
+        for (uint8_t dash = 0; dash < STALE_DASHES; dash++) {
+          PanelT::drawBox(dash * 4, STALE_ROW, 2, 1);
+          PanelT::drawBox(dash * 4, MAIN_HUM_Y + STALE_ROW, 2, 1);
+        }
+      }
+  });
+
+  changedTiles(shownTemp, tempStr);
+  changedTiles(shownHum, humStr);
+  shownStale = stale;
+  mainShown = true;
+  Telemetry::countFrame();
+  TRACE(TRACE_DISPLAY_MAIN_END);
 }
 
-void Display::displayChart(float data[28], bool temp) {
-  // 1. Calculate Min/Max OUTSIDE the loop (Optimization)
-  float maxVal = -1000;
-  float minVal = 1000;
-  for (int i = 0; i < 28; i++) {
-    if (data[i] > maxVal) maxVal = data[i];
-    if (data[i] < minVal) minVal = data[i];
+/**
+ * Compare a new readout with what is shown and remember it.
+ *
+ * @return Bit mask of the 16 tile columns covering characters that changed.
+ */
+uint16_t DisplayBase::changedTiles(uint8_t *shown, const char *text) {
+  uint16_t tiles = 0;
+  bool ended = false;
+  for (uint8_t i = 0; i < MAIN_CHARS; i++) {
+    if (!ended && text[i] == '\0') ended = true; // never read past the terminator, the buffer may end there
+    uint8_t glyph = ended ? Font::NONE : charIndex(text[i]);
+    if (glyph == shown[i]) continue;
+    shown[i] = glyph;
+
+    uint8_t left = MAIN_TEXT_X + i * 24; // each character is 24 pixels wide at scale 4
+    uint8_t right = left + 23 > 127 ? 127 : left + 23;
+    for (uint8_t tile = left / 8; tile <= right / 8; tile++) tiles |= 1 << tile;
   }
+  return tiles;
+}
 
-  maxVal += 2;
-  minVal -= 2;
+/**
+ * The byte of display RAM at column x of a page on the main screen, composed from the glyphs that overlap it.
+ * Needed because the readouts are not tile aligned, so one tile can hold parts of two characters.
+ */
+uint8_t DisplayBase::mainColumn(uint8_t x, uint8_t page) {
+  static_assert(MAIN_HUM_Y % 4 == 0, "the humidity line must start on a multiple of the readout scale");
+  bool humidityLine = page >= 4;
+  int8_t top = humidityLine ? MAIN_HUM_Y : 0;
+
+  if (x < MAIN_TEXT_X) {
+    // 2x label: 4 glyph rows per page
+    uint16_t bits = glyphColumn(humidityLine ? HUM_LABEL : TEMP_LABEL, x / 2);
+    int8_t first = (int8_t) (page * 8 - top) / 2; // glyph row at the top of the page
+    uint16_t rows = first >= 0 ? bits >> first : bits << -first;
+    uint8_t column = pgm_read_byte(&spread2.v[rows & 0x0F]);
+
+    // stale marker: the dashes cover the even pairs of columns 0..9
+    uint8_t markerRow = top + STALE_ROW;
+    if (shownStale && x < STALE_DASHES * 4 && (x & 2) == 0 && markerRow / 8 == page) column |= 1 << markerRow % 8;
+    return column;
+  }
 
-  // 2. Prepare Strings OUTSIDE the loop
-  const char *title = temp ? "TEMP" : "HUMID";
-  int strSize = (int) strlen(title) * 6;
-  int startPoint = 72 - (strSize / 2);
-
-  // Cache the axis labels
-  char maxLabel[8]; strcpy(maxLabel, formatAxisLabels((int)(0.5f + maxVal)));
-  char minLabel[8]; strcpy(minLabel, formatAxisLabels((int)(0.5f + minVal)));
-
-  // 3. FIXED: Page Buffer Loop
-  u8g2.firstPage();
-  do {
-      for (int i = 0; i < 28; i++) {
-        // Scale bar height to 53px max
-        int barHeight = (int) ((float) (data[27-i] - minVal) / (float) (maxVal - minVal) * 53.0f);
-        if (barHeight < 0) barHeight = 0;
-        if (barHeight > 64) barHeight = 64;
-
-        // Draw each bar: x offset starts at 16, each bar is 3px wide
-        u8g2.drawBox(16 + i * 4, 64 - barHeight, 3, barHeight);
+  // 4x readout: 2 glyph rows per page
+  uint8_t offset = x - MAIN_TEXT_X;
+  uint16_t bits = glyphColumn((humidityLine ? shownHum : shownTemp)[offset / 24], (offset % 24) / 4);
+  int8_t first = (int8_t) (page * 8 - top) / 4;
+  uint16_t rows = first >= 0 ? bits >> first : bits << -first;
+  return pgm_read_byte(&spread4.v[rows & 0x03]);
+}
+
+/**
+ * Send the tiles in the given columns of pages firstPage..lastPage straight to the SSD1306 via u8x8, in runs of
+ * up to MAIN_TILE_RUN adjacent tiles.
+ */
+template<typename PanelT>
+void DisplayT<PanelT>::drawMainTiles(uint16_t tiles, uint8_t firstPage, uint8_t lastPage) {
+  if (!tiles) return;
+  uint8_t run[MAIN_TILE_RUN * 8];
+  for (uint8_t page = firstPage; page <= lastPage; page++) {
+    uint8_t tile = 0;
+    while (tile < 16) {
+      if (!(tiles & (1 << tile))) {
+        tile++;
+        continue;
+      }
+      uint8_t start = tile;
+      uint8_t count = 0;
+      while (tile < 16 && (tiles & (1 << tile)) && count < MAIN_TILE_RUN) {
+        for (uint8_t col = 0; col < 8; col++) run[count * 8 + col] = mainColumn(tile * 8 + col, page);
+        count++;
+        tile++;
       }
+      PanelT::drawTiles(start, page, count, run);
+    }
+  }
+}
+
+template<typename PanelT>
+template<typename History>
+void DisplayT<PanelT>::displayChart(const History &history, LoggerCodec::Channel channel) {
+  TRACE(TRACE_DISPLAY_CHART_BEGIN);
+  mainShown = false; // the chart overwrites the whole panel
+  // 1. Calculate Min/Max OUTSIDE the loop, on scaled cells (see LoggerCodec::scaled)
+  uint16_t maxVal = 0;
+  uint16_t minVal = UINT16_MAX;
+  history.visit(channel, [&](uint8_t, uint8_t encoded) {
+      uint16_t value = LoggerCodec::scaled(channel, encoded);
+      if (value > maxVal) maxVal = value;
+      if (value < minVal) minVal = value;
+  });
+
+  // 2 units of headroom above and below the data
+  constexpr uint16_t PAD = 2 * LoggerCodec::UNIT;
+  uint16_t range = maxVal - minVal + 2 * PAD;
+
+  // 2. Prepare Strings OUTSIDE the loop
+  bool temp = LoggerCodec::isTemperature(channel);
+  const uint8_t *title = temp ? tempTitle.glyphs : humidTitle.glyphs;
+  uint8_t titleLength = temp ? tempTitle.length() : humidTitle.length();
+  int startPoint = 72 - (titleLength * Font::WIDTH / 2);
+
+  // Cache the axis labels, rounded as (int) (0.5f + value) would
+  int32_t offset = (int32_t) LoggerCodec::channelMin(channel) * LoggerCodec::UNIT;
+  char maxLabel[8]; strcpy(maxLabel, formatAxisLabels((2 * (offset + maxVal + PAD) + LoggerCodec::UNIT) / (2 * LoggerCodec::UNIT)));
+  char minLabel[8]; strcpy(minLabel, formatAxisLabels((2 * (offset + minVal - PAD) + LoggerCodec::UNIT) / (2 * LoggerCodec::UNIT)));
+
+  // 3. FIXED: Page Buffer Loop, reading the history again for each page instead of keeping a copy
+  PanelT::render([&]() {
+      history.visit(channel, [&](uint8_t i, uint8_t encoded) {
+          // Scale bar height to 53px max, the newest sample leftmost
+          uint8_t barHeight = (uint32_t) (LoggerCodec::scaled(channel, encoded) - minVal + PAD) * 53 / range;
+
+          // Draw each bar: x offset starts at 16, each bar is 3px wide
+          PanelT::drawBox(16 + (History::NUM_SAMPLES - 1 - i) * 4, 64 - barHeight, 3, barHeight);
+      });
 
       // Title
-      drawStringScale(startPoint, 0, title, 1);
+      drawGlyphs(startPoint, 0, title, titleLength);
 
       // Y-axis labels
       drawStringScale(0, 12, maxLabel, 1);
       drawStringScale(0, 56, minLabel, 1);
 
       // Axes lines
-      u8g2.drawLine(16, 64, 16, 0);   // y-axis
-      u8g2.drawLine(0, 64, 128, 64);  // x-axis
-      u8g2.drawLine(16, 10, 128, 10); // top cap
+      PanelT::drawLine(16, 64, 16, 0);   // y-axis
+      PanelT::drawLine(0, 64, 128, 64);  // x-axis
+      PanelT::drawLine(16, 10, 128, 10); // top cap
 
       // 7D Label
-      drawStringScale(128-16 +2, 1, "7D", 1);
+      drawGlyphs(128-16 +2, 1, weekLabel.glyphs, weekLabel.length());
 
-  } while (u8g2.nextPage());
+  });
+  Telemetry::countFrame();
+  TRACE(TRACE_DISPLAY_CHART_END);
 }
 
-char *Display::formatAxisLabels(int value) {
+char *DisplayBase::formatAxisLabels(int value) {
   /**
    * Format chart axis labels for integers.
    * Returns 1–3 digit strings like "-9", "12", "100"
@@ -327,8 +445,17 @@ char *Display::formatAxisLabels(int value) {
   return label;
 }
 
-void Display::powerDown() {
-  u8g2.setPowerSave(1);
+template<typename PanelT>
+void DisplayT<PanelT>::powerDown() {
+  PanelT::setPowerSave(1);
+  mainShown = false;
 }
 
-#endif
\ No newline at end of file
+template class DisplayT<U8g2Panel>;
+template void DisplayT<U8g2Panel>::displayChart(const Logger &, LoggerCodec::Channel);
+#ifdef HAL_ISOLATION
+template class DisplayT<NullPanel>;
+template void DisplayT<NullPanel>::displayChart(const LoggerT<RamStorage> &, LoggerCodec::Channel);
+#endif
+
+#endif
@@ -7,39 +7,97 @@
 
 #ifdef MAIN_BOARD
 
-#include "U8g2lib.h"
+#include "Hal/Avr.h"
 #include <avr/pgmspace.h>
+#include "FontTables.h"
+#include "Logger/LoggerCodec.h"
+
+/**
+ * The panel independent half of the display: font tables, text formatting and the main screen's tile state.
+ */
+class DisplayBase {
+protected:
+    friend class BenchmarkController; // benchmarks the private hot paths
+
+    static const Font::Table<uint8_t, Font::GLYPHS * Font::WIDTH> glyphColumns PROGMEM;
+    static const Font::Table<uint8_t, Font::CHAR_TABLE_SIZE> charTable PROGMEM;
+    static const Font::Table<uint8_t, Font::GLYPHS * Font::HEIGHT> glyphXbm PROGMEM;
+    static const Font::Table<uint8_t, 16> spread2 PROGMEM;
+    static const Font::Table<uint8_t, 4> spread4 PROGMEM;
+    static const Font::GlyphString<4> tempTitle PROGMEM;
+    static const Font::GlyphString<5> humidTitle PROGMEM;
+    static const Font::GlyphString<2> weekLabel PROGMEM;
+
+    // Main screen layout, shared by the page loop and the tile path
+    constexpr static uint8_t MAIN_CHARS = 5; // readout characters per line
+    constexpr static uint8_t MAIN_TEXT_X = 12; // readouts start after the 2x label
+    constexpr static uint8_t MAIN_HUM_Y = 36; // top of the humidity line, the temperature line is at 0
+    constexpr static uint8_t MAIN_TILE_RUN = 4; // tiles sent per u8x8 call
+    constexpr static uint8_t TEMP_LABEL = Font::index('T');
+    constexpr static uint8_t HUM_LABEL = Font::index('H');
+    constexpr static uint8_t STALE_ROW = 16; // row of the stale marker under each label, from the top of its line
+    constexpr static uint8_t STALE_DASHES = 3; // 2 pixel dashes, 2 pixels apart, under the 10 pixel wide label
+    constexpr static uint16_t STALE_TILES = 0x0003; // tile columns 0 and 1, which the marker falls in
+
+    // What the main screen currently shows, so a refresh only redraws the tiles of characters that changed.
+    // Invalid whenever anything else has been drawn or the panel was off.
+    bool mainShown = false;
+    uint8_t shownTemp[MAIN_CHARS]; // glyph indices
+    uint8_t shownHum[MAIN_CHARS];
+    bool shownStale = false; // the readouts are the last logged sample, not a live reading
 
-class Display {
+    uint8_t charIndex(char c);
+
+    uint8_t glyphColumn(uint8_t glyph, uint8_t col);
+
+    uint8_t mainColumn(uint8_t x, uint8_t page);
+
+    uint16_t changedTiles(uint8_t *shown, const char *text);
+
+    const char *formattedTempString(float temperature);
+
+    char *formattedHumString(float humidity);
+
+    char* formatAxisLabels(int value);
+};
+
+/**
+ * The screens drawn on a Panel (see Hal/Panel.h). The firmware uses Display, the SSD1306 through U8g2.
+ */
+template<typename PanelT>
+class DisplayT : public DisplayBase {
 public:
     void setup();
 
-    void displayMain(float temperature, float humidity);
+    /**
+     * Show a reading on the main screen. A stale one (the last logged sample, shown while the sensor converts) gets a
+     * dashed rule under each label, which the next live reading clears along with the characters that changed.
+     */
+    void displayMain(float temperature, float humidity, bool stale = false);
 
-    void displayChart(float *data, bool temp);
+    /** Draw a channel of a Logger's history as a bar chart, scaling the encoded cells as they are read. */
+    template<typename History>
+    void displayChart(const History &history, LoggerCodec::Channel channel);
 
     void powerDown();
 
 
 private:
-    // CHANGED: _F_ -> _1_ (Saves 896 bytes of RAM)
-    static U8G2_SSD1306_128X64_NONAME_1_HW_I2C u8g2;
-    static const uint8_t font6x8_digits[][6] PROGMEM;
+    friend class BenchmarkController; // benchmarks the private hot paths
 
-    uint8_t charIndex(char c);
-
-    void drawCharScale(uint8_t x0, uint8_t y0, char c, const int scale);
+    void drawGlyphScale(uint8_t x0, uint8_t y0, uint8_t glyph, uint8_t scale);
 
-    void drawStringScale(uint8_t x, uint8_t y, const char *s, const int scale);
+    void drawGlyphs(uint8_t x, uint8_t y, const uint8_t *glyphs, uint8_t count);
 
-    const char *formattedTempString(float temperature);
+    void drawMainTiles(uint16_t tiles, uint8_t firstPage, uint8_t lastPage);
 
-    char *formattedHumString(float humidity);
-
-    char* formatAxisLabels(int value);
+    void drawCharScale(uint8_t x0, uint8_t y0, char c, const int scale);
 
+    void drawStringScale(uint8_t x, uint8_t y, const char *s, const int scale);
 };
 
+using Display = DisplayT<U8g2Panel>;
+
 #endif // MAIN_BOARD
 
 #endif //TEMPSENSOR_DISPLAY_H
\ No newline at end of file
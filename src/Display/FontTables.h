@@ -0,0 +1,143 @@
+/**
+ * FontTables – the 6x8 font of Display and the lookup tables the compiler generates from it.
+ *
+ * Everything here is constexpr, so the tables cost flash but no start-up time, and label strings can be turned
+ * into glyph indices at compile time. Shared with tools/font_report, so keep it free of Arduino and AVR headers.
+ */
+
+#ifndef TEMPERATURETRACKER_FONTTABLES_H
+#define TEMPERATURETRACKER_FONTTABLES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct Font {
+    static constexpr uint8_t WIDTH = 6;
+    static constexpr uint8_t HEIGHT = 8;
+    static constexpr uint8_t GLYPHS = 22;
+    static constexpr uint8_t NONE = 0xFF; // index of characters without a glyph (including ' ')
+
+    // Glyphs as 6 columns each, bit 0 at the top
+    static constexpr uint8_t COLUMNS[GLYPHS][WIDTH] = {
+            // Digits 0–9
+            {0x3E, 0x51, 0x49, 0x45, 0x3E, 0x00},  // 0
+            {0x00, 0x42, 0x7F, 0x40, 0x00, 0x00},  // 1
+            {0x42, 0x61, 0x51, 0x49, 0x46, 0x00},  // 2
+            {0x21, 0x41, 0x45, 0x4B, 0x31, 0x00},  // 3
+            {0x18, 0x14, 0x12, 0x7F, 0x10, 0x00},  // 4
+            {0x27, 0x45, 0x45, 0x45, 0x39, 0x00},  // 5
+            {0x3C, 0x4A, 0x49, 0x49, 0x30, 0x00},  // 6
+            {0x01, 0x71, 0x09, 0x05, 0x03, 0x00},  // 7
+            {0x36, 0x49, 0x49, 0x49, 0x36, 0x00},  // 8
+            {0x06, 0x49, 0x49, 0x29, 0x1E, 0x00},  // 9
+
+            // Special characters: . d % -
+            {0x00, 0x00, 0x60, 0x60, 0x00, 0x00},  // .
+            {0x06, 0x09, 0x09, 0x06, 0x00, 0x00},  // d (degree)
+            {0x62, 0x64, 0x08, 0x13, 0x23, 0x00},  // %
+            {0x08, 0x08, 0x08, 0x08, 0x08, 0x00},  // -
+
+            // Letters used for labels
+            {0x01, 0x01, 0x7F, 0x01, 0x01, 0x00},  // T
+            {0x7F, 0x08, 0x08, 0x08, 0x7F, 0x00},  // H
+            {0x7F, 0x49, 0x49, 0x49, 0x41, 0x00},  // E
+            {0x7F, 0x02, 0x04, 0x02, 0x7F, 0x00},  // M
+            {0x7F, 0x09, 0x09, 0x09, 0x06, 0x00},  // P
+            {0x3F, 0x40, 0x40, 0x40, 0x3F, 0x00},  // U
+            {0x00, 0x41, 0x7F, 0x41, 0x00, 0x00},  // I
+            {0x7F, 0x41, 0x41, 0x22, 0x1C, 0x00},  // D
+    };
+
+    // The character each glyph draws, in the order of COLUMNS
+    static constexpr char CHARS[GLYPHS + 1] = "0123456789.d%-THEMPUID";
+
+    // Range of characters covered by the character table
+    static constexpr char FIRST_CHAR = '%';
+    static constexpr char LAST_CHAR = 'd';
+    static constexpr uint8_t CHAR_TABLE_SIZE = LAST_CHAR - FIRST_CHAR + 1;
+
+    /** Fixed size array that can be built by a constexpr function and stored in PROGMEM as a whole. */
+    template<typename T, uint16_t N>
+    struct Table {
+        T v[N];
+    };
+
+    /** Glyph indices of a string, see glyphs(). */
+    template<uint8_t N>
+    struct GlyphString {
+        uint8_t glyphs[N];
+
+        static constexpr uint8_t length() { return N; }
+
+        static constexpr uint8_t width() { return N * WIDTH; } // in pixels at scale 1
+    };
+
+    /** Glyph index of a character, NONE if the font has no glyph for it. */
+    static constexpr uint8_t index(char c) {
+      for (uint8_t i = 0; i < GLYPHS; i++) {
+        if (CHARS[i] == c) return i;
+      }
+      return NONE;
+    }
+
+    /** Glyph indices of a string literal, worked out by the compiler. */
+    template<size_t N>
+    static constexpr GlyphString<N - 1> glyphs(const char (&text)[N]) {
+      GlyphString<N - 1> result{};
+      for (size_t i = 0; i + 1 < N; i++) result.glyphs[i] = index(text[i]);
+      return result;
+    }
+
+    /** COLUMNS as one flat table. */
+    static constexpr Table<uint8_t, GLYPHS * WIDTH> columnTable() {
+      Table<uint8_t, GLYPHS * WIDTH> table{};
+      for (uint8_t glyph = 0; glyph < GLYPHS; glyph++) {
+        for (uint8_t col = 0; col < WIDTH; col++) table.v[glyph * WIDTH + col] = COLUMNS[glyph][col];
+      }
+      return table;
+    }
+
+    /** FIRST_CHAR..LAST_CHAR → glyph index, replacing a search per character at run time. */
+    static constexpr Table<uint8_t, CHAR_TABLE_SIZE> charTable() {
+      Table<uint8_t, CHAR_TABLE_SIZE> table{};
+      for (uint8_t i = 0; i < CHAR_TABLE_SIZE; i++) table.v[i] = index((char) (FIRST_CHAR + i));
+      return table;
+    }
+
+    /**
+     * Every glyph as an 8-row XBM bitmap (row major, bit 0 is the leftmost pixel), so a glyph at scale 1 is a
+     * single drawXBMP call.
+     */
+    static constexpr Table<uint8_t, GLYPHS * HEIGHT> xbmTable() {
+      Table<uint8_t, GLYPHS * HEIGHT> table{};
+      for (uint8_t glyph = 0; glyph < GLYPHS; glyph++) {
+        for (uint8_t row = 0; row < HEIGHT; row++) {
+          uint8_t bits = 0;
+          for (uint8_t col = 0; col < WIDTH; col++) {
+            if (COLUMNS[glyph][col] & (1 << row)) bits |= 1 << col;
+          }
+          table.v[glyph * HEIGHT + row] = bits;
+        }
+      }
+      return table;
+    }
+
+    /**
+     * Vertical scaling of glyph columns: entry n is the byte of display RAM for the low 8 / scale rows of a column
+     * n, each row repeated `scale` times. Scale must divide 8.
+     */
+    template<uint8_t Scale>
+    static constexpr Table<uint8_t, (1 << (8 / Scale))> spreadTable() {
+      Table<uint8_t, (1 << (8 / Scale))> table{};
+      for (uint16_t n = 0; n < (1 << (8 / Scale)); n++) {
+        uint8_t bits = 0;
+        for (uint8_t row = 0; row < 8 / Scale; row++) {
+          if (n & (1 << row)) bits |= ((1 << Scale) - 1) << (row * Scale);
+        }
+        table.v[n] = bits;
+      }
+      return table;
+    }
+};
+
+#endif //TEMPERATURETRACKER_FONTTABLES_H
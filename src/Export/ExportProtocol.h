@@ -0,0 +1,65 @@
+/**
+ * ExportProtocol – framing of the UART export stream (see Exporter).
+ *
+ * Shared with the host receiver in tools/export, so keep it free of Arduino and AVR headers.
+ *
+ * Every frame is
+ *   [0]      SYNC (0xA5)
+ *   [1]      type
+ *   [2..3]   offset into the export image, little endian
+ *   [4]      payload length (0-32)
+ *   [5..]    payload
+ *   [last 2] CRC-16/XMODEM over type..payload, little endian
+ *
+ * The export image is the whole EEPROM (history, telemetry, ...) followed by the raw BME280 calibration
+ * registers 0x88-0xA1 and 0xE1-0xE7. The device streams DATA frames from the current offset to the end and then
+ * sends END with the CRC of the whole image. The receiver sends RESUME with the first offset it is missing
+ * whenever it sees a gap, a bad frame or silence, and DONE once it has everything.
+ */
+
+#ifndef TEMPERATURETRACKER_EXPORTPROTOCOL_H
+#define TEMPERATURETRACKER_EXPORTPROTOCOL_H
+
+#include <stdint.h>
+
+struct ExportProtocol {
+    static constexpr uint8_t VERSION = 1;
+
+    // 500 kBd is the fastest rate that divides exactly from 20, 16 and 10 MHz without double speed mode
+    static constexpr uint32_t BAUD = 500000;
+
+    static constexpr uint8_t SYNC = 0xA5;
+    static constexpr uint8_t HEADER_SIZE = 5;
+    static constexpr uint8_t CRC_SIZE = 2;
+    static constexpr uint8_t MAX_PAYLOAD = 32;
+    static constexpr uint8_t MAX_FRAME = HEADER_SIZE + MAX_PAYLOAD + CRC_SIZE;
+    static constexpr uint8_t COMMAND_FRAME = HEADER_SIZE + CRC_SIZE; // host commands carry no payload
+
+    enum Type : uint8_t {
+        // device → host
+        HELLO = 0x01,  // payload: VERSION, image size (uint16)
+        DATA = 0x02,   // payload: image bytes starting at offset
+        END = 0x03,    // payload: CRC of the whole image (uint16)
+        // host → device
+        RESUME = 0x10, // continue streaming from offset
+        DONE = 0x11,   // everything received, leave export mode
+    };
+
+    // layout of the export image
+    static constexpr uint16_t EEPROM_OFFSET = 0;
+    static constexpr uint16_t EEPROM_BYTES = 256;
+    static constexpr uint16_t CALIBRATION_OFFSET = EEPROM_OFFSET + EEPROM_BYTES;
+    static constexpr uint16_t CALIBRATION_BYTES = 33;
+    static constexpr uint16_t IMAGE_SIZE = CALIBRATION_OFFSET + CALIBRATION_BYTES;
+
+    /** One byte of CRC-16/XMODEM (polynomial 0x1021, start with 0), same as avr-libc _crc_xmodem_update. */
+    static inline uint16_t crcUpdate(uint16_t crc, uint8_t data) {
+      crc ^= (uint16_t) data << 8;
+      for (uint8_t bit = 0; bit < 8; bit++) {
+        crc = (crc & 0x8000) ? (uint16_t) ((crc << 1) ^ 0x1021) : (uint16_t) (crc << 1);
+      }
+      return crc;
+    }
+};
+
+#endif //TEMPERATURETRACKER_EXPORTPROTOCOL_H
@@ -0,0 +1,125 @@
+#ifdef MAIN_BOARD
+
+#include "Exporter.h"
+#include <EEPROM.h>
+#include <avr/wdt.h>
+
+/**
+ * Run the export session. Returns when the host is done or has gone away.
+ */
+void Exporter::run() {
+  Serial.begin(ExportProtocol::BAUD);
+
+  frame[ExportProtocol::HEADER_SIZE] = ExportProtocol::VERSION;
+  frame[ExportProtocol::HEADER_SIZE + 1] = ExportProtocol::IMAGE_SIZE & 0xFF;
+  frame[ExportProtocol::HEADER_SIZE + 2] = ExportProtocol::IMAGE_SIZE >> 8;
+  sendFrame(ExportProtocol::HELLO, 0, 3);
+
+  uint16_t cursor = 0; // next image offset to send
+  bool endSent = false;
+  unsigned long lastHeard = millis();
+
+  while (true) {
+    wdt_reset();
+
+    uint8_t type;
+    uint16_t offset;
+    if (receiveCommand(type, offset)) {
+      lastHeard = millis();
+      if (type == ExportProtocol::DONE) break;
+      if (type == ExportProtocol::RESUME && offset <= ExportProtocol::IMAGE_SIZE) {
+        cursor = offset;
+        endSent = false;
+      }
+    }
+
+    if (cursor < ExportProtocol::IMAGE_SIZE) {
+      // next chunk of the image
+      uint8_t length = ExportProtocol::MAX_PAYLOAD;
+      if (ExportProtocol::IMAGE_SIZE - cursor < length) length = ExportProtocol::IMAGE_SIZE - cursor;
+      for (uint8_t i = 0; i < length; i++) frame[ExportProtocol::HEADER_SIZE + i] = imageByte(cursor + i);
+      sendFrame(ExportProtocol::DATA, cursor, length);
+      cursor += length;
+    } else if (!endSent) {
+      uint16_t crc = imageCrc();
+      frame[ExportProtocol::HEADER_SIZE] = crc & 0xFF;
+      frame[ExportProtocol::HEADER_SIZE + 1] = crc >> 8;
+      sendFrame(ExportProtocol::END, cursor, 2);
+      endSent = true;
+      lastHeard = millis();
+    } else if (millis() - lastHeard > IDLE_TIMEOUT) {
+      break; // nobody is listening
+    } else {
+      delay(1); // wait for the host to ask for more or finish
+    }
+  }
+
+  Serial.flush();
+  Serial.end();
+}
+
+/**
+ * One byte of the export image.
+ *
+ * @param offset Offset into the image, below ExportProtocol::IMAGE_SIZE.
+ */
+uint8_t Exporter::imageByte(uint16_t offset) {
+  if (offset < ExportProtocol::CALIBRATION_OFFSET) return EEPROM.read(offset - ExportProtocol::EEPROM_OFFSET);
+  return sensor.readCalibrationRegister(offset - ExportProtocol::CALIBRATION_OFFSET);
+}
+
+/**
+ * CRC of the whole image, sent with END so the host can check the reassembled result.
+ */
+uint16_t Exporter::imageCrc() {
+  uint16_t crc = 0;
+  for (uint16_t offset = 0; offset < ExportProtocol::IMAGE_SIZE; offset++) {
+    crc = ExportProtocol::crcUpdate(crc, imageByte(offset));
+  }
+  return crc;
+}
+
+/**
+ * Fill in the header and CRC of the payload already in `frame` and send it.
+ */
+void Exporter::sendFrame(uint8_t type, uint16_t offset, uint8_t length) {
+  frame[0] = ExportProtocol::SYNC;
+  frame[1] = type;
+  frame[2] = offset & 0xFF;
+  frame[3] = offset >> 8;
+  frame[4] = length;
+
+  uint16_t crc = 0;
+  for (uint8_t i = 1; i < ExportProtocol::HEADER_SIZE + length; i++) crc = ExportProtocol::crcUpdate(crc, frame[i]);
+  frame[ExportProtocol::HEADER_SIZE + length] = crc & 0xFF;
+  frame[ExportProtocol::HEADER_SIZE + length + 1] = crc >> 8;
+
+  Serial.write(frame, ExportProtocol::HEADER_SIZE + length + ExportProtocol::CRC_SIZE);
+}
+
+/**
+ * Collect bytes of a host command without blocking.
+ *
+ * @return True once a complete command with a valid CRC has arrived.
+ */
+bool Exporter::receiveCommand(uint8_t &type, uint16_t &offset) {
+  while (Serial.available()) {
+    uint8_t b = Serial.read();
+    if (commandLength == 0 && b != ExportProtocol::SYNC) continue; // hunt for the start of a frame
+    command[commandLength++] = b;
+    if (commandLength < ExportProtocol::COMMAND_FRAME) continue;
+
+    commandLength = 0;
+    uint16_t crc = 0;
+    for (uint8_t i = 1; i < ExportProtocol::HEADER_SIZE; i++) crc = ExportProtocol::crcUpdate(crc, command[i]);
+    uint16_t received = command[ExportProtocol::HEADER_SIZE] | (command[ExportProtocol::HEADER_SIZE + 1] << 8);
+    if (crc != received || command[4] != 0) continue; // corrupted, the host will repeat itself
+
+    type = command[1];
+    offset = command[2] | (command[3] << 8);
+    return true;
+  }
+  return false;
+}
+
+#endif
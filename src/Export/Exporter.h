@@ -0,0 +1,41 @@
+#ifndef TEMPERATURETRACKER_EXPORTER_H
+#define TEMPERATURETRACKER_EXPORTER_H
+
+#ifdef MAIN_BOARD
+
+#include "Arduino.h"
+#include "ExportProtocol.h"
+#include "Sensor/Sensor.h"
+
+/**
+ * Exporter – streams the export image (EEPROM and sensor calibration) over the UART using ExportProtocol.
+ *
+ * Only one frame is ever buffered, so RAM use does not depend on how much history is exported.
+ */
+class Exporter {
+public:
+    explicit Exporter(Sensor &sensor) : sensor(sensor) {}
+
+    /** Stream until the host sends DONE or goes quiet for IDLE_TIMEOUT ms. */
+    void run();
+
+private:
+    constexpr static unsigned long IDLE_TIMEOUT = 5000; // ms without host commands after END before giving up
+
+    Sensor &sensor;
+    uint8_t frame[ExportProtocol::MAX_FRAME]; // the frame being sent
+    uint8_t command[ExportProtocol::COMMAND_FRAME]; // the host command being received
+    uint8_t commandLength = 0;
+
+    uint8_t imageByte(uint16_t offset);
+
+    uint16_t imageCrc();
+
+    void sendFrame(uint8_t type, uint16_t offset, uint8_t length);
+
+    bool receiveCommand(uint8_t &type, uint16_t &offset);
+};
+
+#endif // MAIN_BOARD
+
+#endif //TEMPERATURETRACKER_EXPORTER_H
@@ -0,0 +1,35 @@
+#ifdef MAIN_BOARD
+
+#include "Avr.h"
+
+// 128x64 I2C OLED, no reset pin used
+U8G2_SSD1306_128X64_NONAME_1_HW_I2C U8g2Panel::u8g2 = U8G2_SSD1306_128X64_NONAME_1_HW_I2C(U8G2_R0, U8X8_PIN_NONE);
+
+static_assert(EepromStorage::PAGE_SIZE == EEPROM_PAGE_SIZE, "Storage::PAGE_SIZE must be the NVM page size");
+
+/**
+ * Bring one EEPROM page to `page` in a single NVM erase/write: the bytes that differ are loaded into the page buffer
+ * and only those are erased and written, the rest of the page keeps its contents.
+ *
+ * @param address Start of the page, a multiple of PAGE_SIZE.
+ * @param page The PAGE_SIZE bytes it should hold.
+ * @return Microseconds from the erase/write command until the NVM is ready again, 0 if nothing differed.
+ */
+uint16_t EepromStorage::updatePage(uint16_t address, const uint8_t *page) {
+  while (NVMCTRL.STATUS & NVMCTRL_EEBUSY_bm); // the page buffer is in use until the previous write is done
+  _PROTECTED_WRITE_SPM(NVMCTRL.CTRLA, NVMCTRL_CMD_PAGEBUFCLR_gc);
+  bool loaded = false;
+  for (uint8_t i = 0; i < PAGE_SIZE; i++) {
+    if (read(address + i) == page[i]) continue;
+    *(volatile uint8_t *) (MAPPED_EEPROM_START + address + i) = page[i];
+    loaded = true;
+  }
+  if (!loaded) return 0;
+
+  uint32_t start = micros();
+  _PROTECTED_WRITE_SPM(NVMCTRL.CTRLA, NVMCTRL_CMD_PAGEERASEWRITE_gc);
+  while (NVMCTRL.STATUS & NVMCTRL_EEBUSY_bm);
+  return (uint16_t) (micros() - start);
+}
+
+#endif
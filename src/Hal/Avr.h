@@ -0,0 +1,123 @@
+#ifndef TEMPERATURETRACKER_AVR_H
+#define TEMPERATURETRACKER_AVR_H
+
+#ifdef MAIN_BOARD
+
+#include "Arduino.h"
+#include <Wire.h>
+#include <EEPROM.h>
+#include "U8g2lib.h"
+#include "Bus.h"
+#include "Storage.h"
+#include "Panel.h"
+#include "Telemetry/Telemetry.h"
+
+/*
+ * The peripherals of the board: TWI through Wire, the EEPROM, and the SSD1306 through U8g2. The host build links
+ * its stand-ins for Wire, EEPROM and U8g2 under these same types.
+ */
+
+/** The TWI peripheral. */
+class WireBus : public Bus<WireBus> {
+public:
+    static void begin() {
+      Wire.begin();
+      // a bus left busy with no activity for 200 us goes back to idle, so the TWI never waits forever to START
+      TWI0.MCTRLA |= TWI_TIMEOUT_200US_gc;
+    }
+
+    static void end() { Wire.end(); }
+
+    static bool write(uint8_t address, const uint8_t *data, uint8_t count) {
+      if (sdaHeld()) return false; // a START would only wait for the timeout, leave it to recover()
+      Wire.beginTransmission(address);
+      for (uint8_t i = 0; i < count; i++) Wire.write(data[i]);
+      return Wire.endTransmission() == 0;
+    }
+
+    /** Bytes the device did not send read as 0xFF, like Wire.read() does. */
+    static bool read(uint8_t address, uint8_t *dst, uint8_t count) {
+      if (sdaHeld()) return false;
+      bool received = Wire.requestFrom((int) address, (int) count) == count;
+      for (uint8_t i = 0; i < count; i++) dst[i] = Wire.read();
+      return received;
+    }
+
+    /** A device is holding SDA low or the TWI saw a bus error (a START or STOP out of place). */
+    static bool stuck() { return sdaHeld() || (TWI0.MSTATUS & TWI_BUSERR_bm); }
+
+    /**
+     * Free the bus from a device stuck mid-byte (a reset or glitch during a read): clock SCL until it lets go of
+     * SDA, at most 9 clocks for the rest of a byte and its ACK, then send a STOP and restart the TWI.
+     */
+    static void recover() {
+      Wire.end();
+      if (sdaHeld()) Telemetry::countBusRecovery();
+
+      // open drain by hand: the pins are driven low or released to the pull-ups
+      digitalWrite(PIN_WIRE_SCL, LOW);
+      digitalWrite(PIN_WIRE_SDA, LOW);
+      for (uint8_t i = 0; i < 9 && sdaHeld(); i++) {
+        pinMode(PIN_WIRE_SCL, OUTPUT);
+        delayMicroseconds(5);
+        pinMode(PIN_WIRE_SCL, INPUT);
+        delayMicroseconds(5);
+      }
+
+      // STOP: SDA rises while SCL is high
+      pinMode(PIN_WIRE_SDA, OUTPUT);
+      delayMicroseconds(5);
+      pinMode(PIN_WIRE_SDA, INPUT);
+      delayMicroseconds(5);
+      begin();
+      TWI0.MSTATUS = TWI_BUSERR_bm; // write one to clear, so stuck() only sees a new bus error
+    }
+
+private:
+    static bool sdaHeld() { return digitalRead(PIN_WIRE_SDA) == LOW; }
+};
+
+/** The 256-byte EEPROM: one erase/write cycle per byte written, or per page through updatePage(). */
+class EepromStorage : public Storage<EepromStorage> {
+public:
+    static uint8_t read(uint16_t address) { return EEPROM.read(address); }
+
+    static void write(uint16_t address, uint8_t value) { EEPROM.write(address, value); }
+
+    static uint16_t updatePage(uint16_t address, const uint8_t *page);
+};
+
+/** The SSD1306 through U8g2's page buffer (the _1_ variant, 128 bytes of RAM). */
+class U8g2Panel : public Panel<U8g2Panel> {
+public:
+    static void begin() {
+      u8g2.setI2CAddress(0x7A);
+      u8g2.begin();
+      u8g2.setBitmapMode(1); // transparent, so XBM glyphs draw only their "on" pixels like boxes do
+    }
+
+    static void setPowerSave(uint8_t on) { u8g2.setPowerSave(on); }
+
+    static void firstPage() { u8g2.firstPage(); }
+
+    static uint8_t nextPage() { return u8g2.nextPage(); }
+
+    static void drawBox(uint8_t x, uint8_t y, uint8_t w, uint8_t h) { u8g2.drawBox(x, y, w, h); }
+
+    static void drawLine(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1) { u8g2.drawLine(x0, y0, x1, y1); }
+
+    static void drawXBMP(uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t *bitmap) {
+      u8g2.drawXBMP(x, y, w, h, bitmap);
+    }
+
+    static void drawTiles(uint8_t x, uint8_t page, uint8_t count, uint8_t *tiles) {
+      u8x8_DrawTile(u8g2.getU8x8(), x, page, count, tiles);
+    }
+
+private:
+    static U8G2_SSD1306_128X64_NONAME_1_HW_I2C u8g2;
+};
+
+#endif // MAIN_BOARD
+
+#endif //TEMPERATURETRACKER_AVR_H
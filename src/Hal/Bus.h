@@ -0,0 +1,63 @@
+#ifndef TEMPERATURETRACKER_BUS_H
+#define TEMPERATURETRACKER_BUS_H
+
+#ifdef MAIN_BOARD
+
+#include "Arduino.h"
+#include <string.h>
+
+/**
+ * Bus – I2C register access, resolved at compile time.
+ *
+ * An implementation derives from Bus<Itself> and provides static begin(), end(), write(address, data, count),
+ * read(address, dst, count), stuck() and recover(). write and read must return in bounded time, reporting a NACK or
+ * a bus they could not get instead of waiting on it. stuck() tells a failure only recover() can fix (a device holding
+ * the bus, a bus error) from a plain NACK, and recover() frees the bus. The register helpers here are built on those,
+ * so a module templated on its bus inlines straight down to the peripheral calls with no vtable and no object.
+ */
+template<typename Derived>
+class Bus {
+public:
+    /** Attempts per register operation. A failed one is retried as is, after recovering the bus if it is stuck. */
+    static constexpr uint8_t ATTEMPTS = 3;
+
+    /** Write one register. Returns false if every attempt failed. */
+    static bool writeRegister(uint8_t address, uint8_t reg, uint8_t value) {
+      uint8_t data[2] = {reg, value};
+      for (uint8_t attempt = 0; attempt < ATTEMPTS; attempt++) {
+        if (Derived::write(address, data, 2)) return true;
+        if (Derived::stuck()) Derived::recover(); // a NACK leaves the bus idle, there is nothing to recover
+      }
+      return false;
+    }
+
+    /**
+     * Read `count` consecutive registers starting at `reg`. Returns false if every attempt failed, the registers
+     * then read as 0xFF like an absent device's.
+     */
+    static bool readRegisters(uint8_t address, uint8_t reg, uint8_t *dst, uint8_t count) {
+      for (uint8_t attempt = 0; attempt < ATTEMPTS; attempt++) {
+        if (Derived::write(address, &reg, 1) && Derived::read(address, dst, count)) return true;
+        if (Derived::stuck()) Derived::recover();
+      }
+      memset(dst, 0xFF, count);
+      return false;
+    }
+
+    static uint8_t read8(uint8_t address, uint8_t reg) {
+      uint8_t value;
+      readRegisters(address, reg, &value, 1);
+      return value;
+    }
+
+    /** Read a 16-bit register pair, LSB first. */
+    static uint16_t read16(uint8_t address, uint8_t reg) {
+      uint8_t bytes[2];
+      readRegisters(address, reg, bytes, 2);
+      return bytes[0] | (bytes[1] << 8);
+    }
+};
+
+#endif // MAIN_BOARD
+
+#endif //TEMPERATURETRACKER_BUS_H
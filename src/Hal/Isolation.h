@@ -0,0 +1,102 @@
+#ifndef TEMPERATURETRACKER_ISOLATION_H
+#define TEMPERATURETRACKER_ISOLATION_H
+
+#if defined(MAIN_BOARD) && defined(HAL_ISOLATION)
+
+#include "Arduino.h"
+#include <EEPROM.h>
+#include "Bus.h"
+#include "Storage.h"
+#include "Panel.h"
+
+/*
+ * Stand-in peripherals for benchmarking one module at a time (Benchmark environment and host tools). With these a
+ * module's own code is timed without the bus, NVM or panel it normally waits on.
+ */
+
+/** A device whose registers are a RAM array. Every address answers. */
+class RegisterBus : public Bus<RegisterBus> {
+public:
+    inline static uint8_t registers[256];
+
+    static void begin() {}
+
+    static void end() {}
+
+    static bool write(uint8_t, const uint8_t *data, uint8_t count) {
+      if (!count) return true;
+      pointer = data[0];
+      for (uint8_t i = 1; i < count; i++) registers[(uint8_t) (pointer + i - 1)] = data[i];
+      return true;
+    }
+
+    static bool read(uint8_t, uint8_t *dst, uint8_t count) {
+      for (uint8_t i = 0; i < count; i++) dst[i] = registers[(uint8_t) (pointer + i)];
+      return true;
+    }
+
+    static bool stuck() { return false; }
+
+    static void recover() {}
+
+private:
+    inline static uint8_t pointer = 0;
+};
+
+/** 256 bytes of RAM in place of the EEPROM. */
+class RamStorage : public Storage<RamStorage> {
+public:
+    inline static uint8_t cells[256];
+
+    static uint8_t read(uint16_t address) { return cells[address & 0xFF]; }
+
+    static void write(uint16_t address, uint8_t value) { cells[address & 0xFF] = value; }
+};
+
+/**
+ * The real EEPROM without page writes: every changed byte is its own erase/write, finished before the next starts,
+ * the way Logger::push wrote a sample before its page records. The baseline of the logger_push benchmark.
+ */
+class ByteEepromStorage : public Storage<ByteEepromStorage> {
+public:
+    static uint8_t read(uint16_t address) { return EEPROM.read(address); }
+
+    static void write(uint16_t address, uint8_t value) {
+      EEPROM.write(address, value);
+      while (NVMCTRL.STATUS & NVMCTRL_EEBUSY_bm);
+    }
+
+    /** Storage::updatePage(), timed like EepromStorage's. */
+    static uint16_t updatePage(uint16_t address, const uint8_t *page) {
+      uint32_t start = micros();
+      Storage::updatePage(address, page);
+      return (uint16_t) (micros() - start);
+    }
+};
+
+/** A panel that draws nothing but still runs the eight pages of a frame. */
+class NullPanel : public Panel<NullPanel> {
+public:
+    static void begin() {}
+
+    static void setPowerSave(uint8_t) {}
+
+    static void firstPage() { page = 0; }
+
+    static uint8_t nextPage() { return ++page < 8; }
+
+    static void drawBox(uint8_t, uint8_t, uint8_t, uint8_t) {}
+
+    static void drawLine(uint8_t, uint8_t, uint8_t, uint8_t) {}
+
+    static void drawXBMP(uint8_t, uint8_t, uint8_t, uint8_t, const uint8_t *) {}
+
+    static void drawTiles(uint8_t, uint8_t, uint8_t, uint8_t *) {}
+
+private:
+    inline static uint8_t page = 0;
+};
+
+#endif // MAIN_BOARD && HAL_ISOLATION
+
+#endif //TEMPERATURETRACKER_ISOLATION_H
@@ -0,0 +1,30 @@
+#ifndef TEMPERATURETRACKER_PANEL_H
+#define TEMPERATURETRACKER_PANEL_H
+
+#ifdef MAIN_BOARD
+
+#include "Arduino.h"
+
+/**
+ * Panel – the 128x64 monochrome display, resolved at compile time.
+ *
+ * An implementation derives from Panel<Itself> and provides static begin(), setPowerSave(on), firstPage(),
+ * nextPage(), drawBox(), drawLine(), drawXBMP() (transparent, bitmap in PROGMEM) and drawTiles(x, page, count,
+ * tiles), which writes 8x8 tiles straight to the panel RAM outside of any page loop.
+ */
+template<typename Derived>
+class Panel {
+public:
+    /** Run `draw` once per page of the page buffer loop, which is how a whole frame reaches the panel. */
+    template<typename F>
+    static void render(F draw) {
+      Derived::firstPage();
+      do {
+        draw();
+      } while (Derived::nextPage());
+    }
+};
+
+#endif // MAIN_BOARD
+
+#endif //TEMPERATURETRACKER_PANEL_H
@@ -0,0 +1,52 @@
+#ifndef TEMPERATURETRACKER_STORAGE_H
+#define TEMPERATURETRACKER_STORAGE_H
+
+#ifdef MAIN_BOARD
+
+#include "Arduino.h"
+
+/**
+ * Storage – byte addressed non-volatile memory, resolved at compile time.
+ *
+ * An implementation derives from Storage<Itself> and provides static read(address) and write(address, value).
+ * It may also provide updatePage() to write a page in one go (see EepromStorage); the default updates each byte.
+ */
+template<typename Derived>
+class Storage {
+public:
+    static constexpr uint8_t PAGE_SIZE = 32; // NVM page of the tinyAVR 1-series EEPROM
+
+    /** Write a byte only if it differs, to save wear and write time. */
+    static void update(uint16_t address, uint8_t value) {
+      if (Derived::read(address) != value) Derived::write(address, value);
+    }
+
+    template<typename T>
+    static T &get(uint16_t address, T &value) {
+      uint8_t *bytes = (uint8_t *) &value;
+      for (uint8_t i = 0; i < sizeof(T); i++) bytes[i] = Derived::read(address + i);
+      return value;
+    }
+
+    template<typename T>
+    static const T &put(uint16_t address, const T &value) {
+      const uint8_t *bytes = (const uint8_t *) &value;
+      for (uint8_t i = 0; i < sizeof(T); i++) Derived::update(address + i, bytes[i]);
+      return value;
+    }
+
+    /**
+     * Bring one page to `page` (PAGE_SIZE bytes), only writing the bytes that differ.
+     *
+     * @param address Start of the page, a multiple of PAGE_SIZE.
+     * @return The microseconds spent writing, until the memory is ready again. Not measured here, so 0.
+     */
+    static uint16_t updatePage(uint16_t address, const uint8_t *page) {
+      for (uint8_t i = 0; i < PAGE_SIZE; i++) Derived::update(address + i, page[i]);
+      return 0;
+    }
+};
+
+#endif // MAIN_BOARD
+
+#endif //TEMPERATURETRACKER_STORAGE_H
@@ -1,57 +1,76 @@
 #include "Logger.h"
-#include <EEPROM.h>
+#include "Trace/Trace.h"
+#include "Hal/Isolation.h"
 
 #ifdef MAIN_BOARD
 
-// Constants for the temperature and humidity encoding
-float Logger::maxTemp = 60.0f;  // max temperature to store
-float Logger::minTemp = -50.0f; // min temperature to store
-
-float Logger::maxHum = 100.0f;  // max humidity to store
-float Logger::minHum = 0.0f;    // min humidity to store
-
 /**
- * Logger – persistent circular buffer in EEPROM.
- * @param sector  The sector number to use (0-3). Each sector is 57 bytes.
+ * Check the format marker and convert the EEPROM to the page records if it is missing.
  */
-void Logger::begin(uint8_t sector) {
-  if (sector >= MAX_SECTORS) sector = 0;
-  baseAddr = sector * SECTOR_SIZE;
+template<typename StorageT>
+void LoggerT<StorageT>::begin() {
+  if (StorageT::read(LoggerCodec::FORMAT_ADDR) == LoggerCodec::FORMAT_MAGIC &&
+      StorageT::read(LoggerCodec::FORMAT_ADDR + 1) == LoggerCodec::FORMAT_VERSION) {
+    return;
+  }
+  convertFormat1();
+  // marked last, so a conversion cut short by a power loss runs again
+  StorageT::update(LoggerCodec::FORMAT_ADDR, LoggerCodec::FORMAT_MAGIC);
+  StorageT::update(LoggerCodec::FORMAT_ADDR + 1, LoggerCodec::FORMAT_VERSION);
 }
 
 /**
- * Read the front pointer from EEPROM.
- *
- * @return The current front pointer value (0-27).
- */
-uint8_t Logger::readPtr() const { return EEPROM.read(baseAddr); }
-
-/**
- * Write the front pointer to EEPROM.
+ * Find the front pointer: the one on the last page written in the current lap.
  *
- * @param p The new front pointer value (0-27).
+ * @param lap Set to the current lap, page 0's.
+ * @return The slot the next push() writes (0-27).
  */
-void Logger::writePtr(uint8_t p) const { EEPROM.update(baseAddr, p); }
+template<typename StorageT>
+uint8_t LoggerT<StorageT>::front(uint8_t &lap) const {
+  lap = StorageT::read(LoggerCodec::LAP_OFFSET);
+  uint8_t page = 0;
+  while (page + 1 < LoggerCodec::HISTORY_PAGES &&
+         StorageT::read((page + 1) * LoggerCodec::PAGE_SIZE + LoggerCodec::LAP_OFFSET) == lap) {
+    page++;
+  }
+  uint8_t p = StorageT::read(page * LoggerCodec::PAGE_SIZE + LoggerCodec::PTR_OFFSET);
+  return p < NUM_SAMPLES ? p : 0;
+}
 
 /**
- * Push one sample to the circular buffer in EEPROM.
+ * Push one sample to the circular buffer in EEPROM. The record, the front pointer after it and the page's lap are
+ * all on one page, so they reach the EEPROM in a single erase/write and never disagree.
  *
  * @param temp The temperature value to store, as a float.
  * @param hum  The humidity value to store, as a float.
+ * @param millivolts The battery voltage in mV (0 if not measured).
+ * @param probeTemp The external probe's temperature, NAN if it is not attached.
+ * @param probeHum The external probe's humidity, NAN if it is not attached.
  */
-void Logger::push(float temp, float hum) {
-
-  // convert float temps to uint8_t
-
-  uint8_t p = readPtr();
-  if (p >= NUM_SAMPLES) p = 0;
-
-  EEPROM.update(offsTemp(p), encodeTemp(temp));
-  EEPROM.update(offsHum(p), encodeHum(hum));
-
-  /* advance pointer and store it */
-  p = (p + 1) % NUM_SAMPLES;
-  writePtr(p);
+template<typename StorageT>
+void LoggerT<StorageT>::push(float temp, float hum, uint16_t millivolts, float probeTemp, float probeHum) {
+  TRACE(TRACE_LOGGER_PUSH_BEGIN);
+
+  uint8_t lap;
+  uint8_t p = front(lap);
+  uint16_t pageAddr = p / LoggerCodec::RECORDS_PER_PAGE * LoggerCodec::PAGE_SIZE;
+
+  uint8_t page[LoggerCodec::PAGE_SIZE];
+  for (uint8_t i = 0; i < LoggerCodec::PAGE_SIZE; i++) page[i] = StorageT::read(pageAddr + i);
+
+  uint8_t *record = page + p % LoggerCodec::RECORDS_PER_PAGE * LoggerCodec::RECORD_SIZE;
+  record[LoggerCodec::TEMPERATURE] = LoggerCodec::encodeTemp(temp);
+  record[LoggerCodec::HUMIDITY] = LoggerCodec::encodeHum(hum);
+  record[LoggerCodec::PROBE_TEMPERATURE] = isnan(probeTemp) ? LoggerCodec::EMPTY : LoggerCodec::encodeTemp(probeTemp);
+  record[LoggerCodec::PROBE_HUMIDITY] = isnan(probeHum) ? LoggerCodec::EMPTY : LoggerCodec::encodeHum(probeHum);
+  record[LoggerCodec::VOLTAGE_CELL] = LoggerCodec::encodeVoltage(millivolts);
+
+  /* advance the pointer; slot 0 starts a new lap, which page 0 carries */
+  page[LoggerCodec::PTR_OFFSET] = (p + 1) % NUM_SAMPLES;
+  page[LoggerCodec::LAP_OFFSET] = p == 0 ? lap + 1 : lap;
+
+  commitMicros = StorageT::updatePage(pageAddr, page);
+  TRACE(TRACE_LOGGER_PUSH_END);
 }
 
 /**
@@ -59,14 +78,9 @@ void Logger::push(float temp, float hum) {
  *
  * @param dst Pointer to an array of 28 int8_t elements where the temperature values will be stored.
  */
-void Logger::readTemperature(float *dst) {
-  uint8_t p = readPtr();
-  if (p >= NUM_SAMPLES) p = 0;
-
-  for (uint8_t i = 0; i < NUM_SAMPLES; ++i) {
-    uint8_t idx = (p + i) % NUM_SAMPLES;          // oldest → newest
-    dst[i] = decodeTemp(EEPROM.read(offsTemp(idx)));
-  }
+template<typename StorageT>
+void LoggerT<StorageT>::readTemperature(float *dst) {
+  visit(LoggerCodec::TEMPERATURE, [dst](uint8_t i, uint8_t encoded) { dst[i] = LoggerCodec::decodeTemp(encoded); });
 }
 
 /**
@@ -74,100 +88,140 @@ void Logger::readTemperature(float *dst) {
  *
  * @param dst Pointer to an array of 28 int8_t elements where the humidity values will be stored.
  */
-void Logger::readHumidity(float *dst) {
-  uint8_t p = readPtr();
-  if (p >= NUM_SAMPLES) p = 0;
-
-  for (uint8_t i = 0; i < NUM_SAMPLES; ++i) {
-    uint8_t idx = (p + i) % NUM_SAMPLES;
-    dst[i] = decodeHum(EEPROM.read(offsHum(idx)));
-  }
+template<typename StorageT>
+void LoggerT<StorageT>::readHumidity(float *dst) {
+  visit(LoggerCodec::HUMIDITY, [dst](uint8_t i, uint8_t encoded) { dst[i] = LoggerCodec::decodeHum(encoded); });
 }
 
 /**
- * Reset the EEPROM sector to all zeroes.
+ * Read the most recent sample without walking the history, for showing something before the sensor is ready.
+ *
+ * @param temp Set to the newest temperature.
+ * @param hum  Set to the newest humidity.
+ * @return False if the newest cell is empty, temp and hum are then left alone.
  */
-void Logger::resetEEPROM() {
-// on start write all eeprom to unsigned char 0
-  for (uint16_t i = 0; i < SECTOR_SIZE; ++i) {
-    EEPROM.update(baseAddr + i, 0x00);
-  }
+template<typename StorageT>
+bool LoggerT<StorageT>::latest(float &temp, float &hum) const {
+  uint8_t p = front();
+  uint16_t record = LoggerCodec::recordAddr(p == 0 ? NUM_SAMPLES - 1 : p - 1);
+
+  uint8_t encodedTemp = StorageT::read(record + LoggerCodec::TEMPERATURE);
+  uint8_t encodedHum = StorageT::read(record + LoggerCodec::HUMIDITY);
+  if (encodedTemp == LoggerCodec::EMPTY || encodedHum == LoggerCodec::EMPTY) return false;
+  temp = LoggerCodec::decodeTemp(encodedTemp);
+  hum = LoggerCodec::decodeHum(encodedHum);
+  return true;
 }
 
 /**
- * Reset the EEPROM sector to all default values.
+ * Read the 28-entry battery voltage history (oldest → newest).
  *
- * @param defaultTemp The default temperature value to write to the EEPROM.
- * @param defaultHum  The default humidity value to write to the EEPROM.
+ * @param dst Pointer to an array of 28 elements for the voltages in mV, 0 where none was measured.
  */
-void Logger::resetEEMPROM(int8_t defaultTemp, int8_t defaultHum) {
-  for (uint16_t i = 0; i < SECTOR_SIZE; ++i) {
-    if (i == 0) {
-      EEPROM.update(baseAddr + i, 0x00); // reset front pointer
-    } else if (i <= NUM_SAMPLES) {
-      EEPROM.update(baseAddr + i, encodeTemp(defaultTemp)); // write default temperature
-    } else {
-      EEPROM.update(baseAddr + i, encodeHum(defaultHum)); // write default humidity
-    }
-  }
+template<typename StorageT>
+void LoggerT<StorageT>::readVoltage(uint16_t *dst) {
+  visitCell(LoggerCodec::VOLTAGE_CELL, [dst](uint8_t i, uint8_t encoded) {
+    dst[i] = LoggerCodec::decodeVoltage(encoded);
+  });
 }
 
 /**
- * The temperatures are floats but we store them as uint8_t in EEPROM. Do the conversion to some precision here.
+ * Write every history page, one page write each, with the front pointer at `next`.
  *
- * @param temperature The temperature value to encode, as a float.
- * @return  Encoded temperature value as uint8_t.
+ * @param next The slot the next push() should write.
+ * @param record Called as record(slot, cells) to fill the RECORD_SIZE cells of each slot.
  */
-inline uint8_t Logger::encodeTemp(float temperature) {
-  // clamp the value to the encoding range
-  if (temperature < minTemp) temperature = minTemp;
-  if (temperature > maxTemp) temperature = maxTemp;
-
-  // scale to 0-255 range as a float
-  float scaled = (temperature - minTemp) * 255.0f / (maxTemp - minTemp) + 0.5f;
-  // return as uint8_t
-  return static_cast<uint8_t>(scaled);
+template<typename StorageT>
+template<typename F>
+void LoggerT<StorageT>::rewrite(uint8_t next, F record) {
+  // the pages up to the newest record's are in the current lap, the ones after it still in the previous one
+  uint8_t newestPage = (next == 0 ? NUM_SAMPLES - 1 : next - 1) / LoggerCodec::RECORDS_PER_PAGE;
+
+  uint8_t page[LoggerCodec::PAGE_SIZE];
+  for (uint8_t n = 0; n < LoggerCodec::HISTORY_PAGES; n++) {
+    uint16_t pageAddr = n * LoggerCodec::PAGE_SIZE;
+    for (uint8_t i = 0; i < LoggerCodec::PAGE_SIZE; i++) page[i] = StorageT::read(pageAddr + i);
+    for (uint8_t r = 0; r < LoggerCodec::RECORDS_PER_PAGE; r++) {
+      uint8_t slot = n * LoggerCodec::RECORDS_PER_PAGE + r;
+      if (slot < NUM_SAMPLES) record(slot, page + r * LoggerCodec::RECORD_SIZE);
+    }
+    page[LoggerCodec::PTR_OFFSET] = next; // only the newest page's is read
+    page[LoggerCodec::LAP_OFFSET] = n <= newestPage ? 1 : 0;
+    StorageT::updatePage(pageAddr, page);
+  }
 }
 
 /**
- * Decode an EEPROM temperature value to float.
- * @param encodedTemp The encoded temperature value as uint8_t.
- * @return Decoded temperature value as float.
+ * Convert format 1 (see LoggerCodec::Format1) to the page records, keeping the history, its front pointer and the
+ * telemetry block. An erased EEPROM converts to an empty history.
  */
-inline float Logger::decodeTemp(uint8_t encodedTemp) {
-  float encodedValue = static_cast<float>(encodedTemp); // scale back to the original range
-  if (encodedValue == 0xFF) return 0.0f; // handle special case for 0xFF
+template<typename StorageT>
+void LoggerT<StorageT>::convertFormat1() {
+  using Format1 = LoggerCodec::Format1;
+
+  // the records overwrite the old cells, so gather them first
+  uint8_t records[NUM_SAMPLES][LoggerCodec::RECORD_SIZE];
+  for (uint8_t slot = 0; slot < NUM_SAMPLES; slot++) {
+    records[slot][LoggerCodec::TEMPERATURE] = StorageT::read(Format1::TEMP_ADDR + slot);
+    records[slot][LoggerCodec::HUMIDITY] = StorageT::read(Format1::HUM_ADDR + slot);
+    records[slot][LoggerCodec::PROBE_TEMPERATURE] = StorageT::read(Format1::PROBE_TEMP_ADDR + slot);
+    records[slot][LoggerCodec::PROBE_HUMIDITY] = StorageT::read(Format1::PROBE_HUM_ADDR + slot);
+    records[slot][LoggerCodec::VOLTAGE_CELL] = StorageT::read(Format1::VOLTAGE_ADDR + slot);
+  }
+  uint8_t next = StorageT::read(Format1::PTR_ADDR);
+  if (next >= NUM_SAMPLES) next = 0;
+
+  // the telemetry block moves down, copied first byte first so none is overwritten before it is read
+  for (uint8_t i = 0; i < LoggerCodec::TRACE_ADDR - LoggerCodec::TELEMETRY_ADDR; i++) {
+    StorageT::update(LoggerCodec::TELEMETRY_ADDR + i, StorageT::read(Format1::TELEMETRY_ADDR + i));
+  }
 
-  return (encodedTemp * (maxTemp - minTemp) / 255.0f) + minTemp; // return the decoded temperature
+  rewrite(next, [&records](uint8_t slot, uint8_t *cells) {
+    memcpy(cells, records[slot], LoggerCodec::RECORD_SIZE);
+  });
+
+  // no trace summary in the new place yet
+  StorageT::update(LoggerCodec::TRACE_ADDR, 0);
+  StorageT::update(LoggerCodec::TRACE_ADDR + 1, 0);
 }
 
 /**
- * The humidities are floats but we store them as uint8_t in EEPROM. Do the conversion to some precision here.
- *
- * @param humidity The humidity value to encode, as a float.
- * @return  Encoded humidity value as uint8_t.
+ * Rewrite the history with every slot holding the same temperature and humidity, no probe reading and no voltage.
  */
-inline uint8_t Logger::encodeHum(float humidity) {
-  // clamp the value to the encoding range
-  if (humidity < minHum) humidity = minHum;
-  if (humidity > maxHum) humidity = maxHum;
-
-  // scale to 0-255 range as a float
-  float scaledHum = (humidity - minHum) * 255.0f / (maxHum - minHum) +0.5f;
-  // return as uint8_t
-  return static_cast<uint8_t>(scaledHum);
+template<typename StorageT>
+void LoggerT<StorageT>::reset(uint8_t encodedTemp, uint8_t encodedHum) {
+  rewrite(0, [encodedTemp, encodedHum](uint8_t, uint8_t *cells) {
+    cells[LoggerCodec::TEMPERATURE] = encodedTemp;
+    cells[LoggerCodec::HUMIDITY] = encodedHum;
+    cells[LoggerCodec::PROBE_TEMPERATURE] = LoggerCodec::EMPTY;
+    cells[LoggerCodec::PROBE_HUMIDITY] = LoggerCodec::EMPTY;
+    cells[LoggerCodec::VOLTAGE_CELL] = LoggerCodec::EMPTY;
+  });
 }
 
 /**
- * Decode an EEPROM humidity value to float.
- * @param encodedHum The encoded humidity value as uint8_t.
- * @return Decoded humidity value as float.
+ * Reset the history to all zeroes.
  */
-inline float Logger::decodeHum(uint8_t encodedHum) {
-  float encodedValue = static_cast<float>(encodedHum); // scale back to the original range
-  if (encodedValue == 0xFF) return 0.0f; // handle special case for 0xFF
+template<typename StorageT>
+void LoggerT<StorageT>::resetEEPROM() {
+  reset(0x00, 0x00);
+}
 
-  return (encodedHum * (maxHum - minHum) / 255.0f) + minHum; // return the decoded humidity
+/**
+ * Reset the history to all default values.
+ *
+ * @param defaultTemp The default temperature value to write to the EEPROM.
+ * @param defaultHum  The default humidity value to write to the EEPROM.
+ */
+template<typename StorageT>
+void LoggerT<StorageT>::resetEEMPROM(int8_t defaultTemp, int8_t defaultHum) {
+  reset(LoggerCodec::encodeTemp(defaultTemp), LoggerCodec::encodeHum(defaultHum));
 }
 
-#endif
\ No newline at end of file
+template class LoggerT<EepromStorage>;
+#ifdef HAL_ISOLATION
+template class LoggerT<RamStorage>;
+template class LoggerT<ByteEepromStorage>;
+#endif
+
+#endif
@@ -1,10 +1,13 @@
 /**
  * Logger – persistent circular buffer in EEPROM.
  *
- * Layout inside one 57-byte sector:
- *   [0]          : uint8_t frontPtr  (index of NEXT cell to be written, 0-27)
- *   [1 .. 28]    : int8_t  temp[28]  (latest temperatures)
- *   [29 .. 56]   : int8_t  hum[28]   (latest humidities)
+ * The history is a ring of 28 sample records, each a temperature, humidity, probe temperature, probe humidity and
+ * battery voltage cell, six to a 32-byte NVM page so that push() commits a sample with one page erase/write:
+ *   0 .. 159   : pages 0-4, six records [0 .. 29], the front pointer [30] and a lap byte [31] each
+ *   160 .. 199 : per-wake telemetry (Telemetry)
+ *   200 .. 252 : trace summary (Trace, only with TRACE_FLUSH_EEPROM)
+ *   254, 255   : format marker, see begin()
+ * The layout constants and the sample encoding live in LoggerCodec.h, which the host tools share.
  */
 
 #ifndef TEMPERATURETRACKER_LOGGER_H
@@ -12,53 +15,92 @@
 
 
 #include <Arduino.h>
+#include <math.h>
+#include "LoggerCodec.h"
+#include "Hal/Avr.h"
 
-class Logger {
+/** The circular buffer on a Storage (see Hal/Storage.h). The firmware uses Logger, the one in the EEPROM. */
+template<typename StorageT>
+class LoggerT {
 public:
-    static constexpr uint8_t NUM_SAMPLES = 28;
-    static constexpr uint8_t SECTOR_SIZE = NUM_SAMPLES * 2 + 1; // 57
-    static constexpr uint8_t MAX_SECTORS = 4;                   // fits 256-byte EEPROM
-
-    explicit Logger(uint8_t sector = 0) { begin(sector); }
-
-    /** Select which 57-byte sector to use (0-3). */
-    void begin(uint8_t sector = 0);
-
-    /** Push one sample; oldest data is overwritten when the buffer wraps. */
-    void push(float temp, float hum);
+    static constexpr uint8_t NUM_SAMPLES = LoggerCodec::NUM_SAMPLES;
+
+    /**
+     * Check the format marker, and convert a format 1 EEPROM (or format an erased one) to the page records if it is
+     * missing. Call before anything else.
+     */
+    void begin();
+
+    /**
+     * Push one sample, in one page write; oldest data is overwritten when the buffer wraps.
+     * The battery voltage (mV, 0 if unknown) and the external probe's reading (NAN if there is none) go in the same
+     * record.
+     */
+    void push(float temp, float hum, uint16_t millivolts = 0, float probeTemp = NAN, float probeHum = NAN);
+
+    /**
+     * Call visitor(i, encoded) with each cell of a channel straight from storage, oldest (i = 0) → newest, so callers
+     * can work on the encoded history without copying it to RAM.
+     */
+    template<typename F>
+    void visit(LoggerCodec::Channel channel, F visitor) const { visitCell(channel, visitor); }
 
     /** Read the 28-entry history (oldest → newest). Empty cells return 0. */
     void readTemperature(float *dst);  // dst[28]
     void readHumidity(float *dst);  // dst[28]
+    void readVoltage(uint16_t *dst);  // dst[28], mV
+
+    /** The newest sample, two EEPROM reads. False if that cell is empty (nothing logged yet). */
+    bool latest(float &temp, float &hum) const;
+
+    /** Time the last push() spent writing its page, in microseconds (0 if the page already held it). */
+    uint16_t lastCommitMicros() const { return commitMicros; }
 
     void resetEEPROM();
 
     void resetEEMPROM(int8_t defaultTemp = 0, int8_t defaultHum = 0);
 
 private:
-    uint8_t baseAddr = 0;   // start address of chosen sector
-
-    uint8_t readPtr() const;
-
-    void writePtr(uint8_t ptr) const;
-
-    uint16_t offsTemp(uint8_t i) const { return baseAddr + 1 + i; }
-
-    uint16_t offsHum(uint8_t i) const { return baseAddr + 1 + NUM_SAMPLES + i; }
-
-    static float maxTemp;
-    static float minTemp;
-    static float maxHum;
-    static float minHum;
-
-    static inline uint8_t encodeTemp(float temp);
-
-    static inline uint8_t encodeHum(float hum);
-
-    static inline float decodeTemp(uint8_t encodedTemp);
-
-    static inline float decodeHum(uint8_t encodedHum);
-
+    uint16_t commitMicros = 0; // page write time of the last push()
+
+    uint8_t front(uint8_t &lap) const;
+
+    uint8_t front() const {
+      uint8_t lap;
+      return front(lap);
+    }
+
+    /** visit() for any cell of the records, stepping through them without a division per slot. */
+    template<typename F>
+    void visitCell(uint8_t cell, F visitor) const {
+      uint8_t slot = front();
+      uint8_t r = slot % LoggerCodec::RECORDS_PER_PAGE;
+      uint16_t addr = LoggerCodec::recordAddr(slot) + cell;
+      for (uint8_t i = 0; i < NUM_SAMPLES; ++i) {
+        visitor(i, StorageT::read(addr));
+        if (++slot == NUM_SAMPLES) {
+          slot = 0;
+          r = 0;
+          addr = cell;
+        } else if (++r == LoggerCodec::RECORDS_PER_PAGE) {
+          r = 0;
+          addr += LoggerCodec::PAGE_SIZE - (LoggerCodec::RECORDS_PER_PAGE - 1) * LoggerCodec::RECORD_SIZE;
+        } else {
+          addr += LoggerCodec::RECORD_SIZE;
+        }
+      }
+    }
+
+    template<typename F>
+    void rewrite(uint8_t next, F record);
+
+    void convertFormat1();
+
+    void reset(uint8_t encodedTemp, uint8_t encodedHum);
 };
 
+#ifdef MAIN_BOARD
+using Logger = LoggerT<EepromStorage>;
+#endif
+
 #endif //TEMPERATURETRACKER_LOGGER_H
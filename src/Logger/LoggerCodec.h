@@ -0,0 +1,187 @@
+/**
+ * LoggerCodec – the EEPROM layout and sample encoding of Logger.
+ *
+ * This header is shared with the host tools (tools/ingest), so the firmware and anything that decodes
+ * EEPROM dumps use the same definitions. Keep it free of Arduino and AVR headers.
+ */
+
+#ifndef TEMPERATURETRACKER_LOGGERCODEC_H
+#define TEMPERATURETRACKER_LOGGERCODEC_H
+
+#include <stdint.h>
+
+struct LoggerCodec {
+    static constexpr uint8_t NUM_SAMPLES = 28;
+    static constexpr uint16_t EEPROM_SIZE = 256;
+
+    // The history is a ring of sample records, RECORDS_PER_PAGE to a 32-byte NVM page, so one sample goes to the
+    // EEPROM in a single page erase/write. Each page ends with the front pointer as it was after its newest record
+    // and a lap byte: pushing to slot 0 bumps page 0's lap, the others take page 0's lap, so the pages written in the
+    // current lap share it and the last of them holds the live front pointer.
+    static constexpr uint8_t PAGE_SIZE = 32;
+    static constexpr uint8_t RECORD_SIZE = 5; // the channels, then VOLTAGE_CELL
+    static constexpr uint8_t RECORDS_PER_PAGE = 6;
+    static constexpr uint8_t HISTORY_PAGES = (NUM_SAMPLES + RECORDS_PER_PAGE - 1) / RECORDS_PER_PAGE; // 5
+    static constexpr uint8_t PTR_OFFSET = 30; // in a page: index of the NEXT slot to be written
+    static constexpr uint8_t LAP_OFFSET = 31;
+
+    // The areas after the history, and a format marker in the last two bytes (absent on format 1 and erased parts)
+    static constexpr uint16_t TELEMETRY_ADDR = HISTORY_PAGES * PAGE_SIZE; // 160, Telemetry::Block
+    static constexpr uint16_t TRACE_ADDR = 200;                          // trace summary, see Trace.h
+    static constexpr uint16_t FORMAT_ADDR = 254;
+    static constexpr uint8_t FORMAT_MAGIC = 0x4C;
+    static constexpr uint8_t FORMAT_VERSION = 2;
+
+    static constexpr uint8_t EMPTY = 0xFF; // cell value that decodes to 0 (erased EEPROM)
+
+    // Battery voltage, in a record's VOLTAGE_CELL
+    static constexpr uint16_t MIN_MILLIVOLTS = 1800;
+    static constexpr uint8_t MILLIVOLT_STEP = 10;                       // 1.80 V .. 4.34 V
+
+    /**
+     * Format 1, before the page records: four 57-byte sectors of [front pointer, 28 temperatures, 28 humidities],
+     * sector 0 the history and sector 1 the probe's cells in the same slots, and the voltages in the last 28 bytes.
+     * Logger converts it on begin(), the ingest tools still decode it.
+     */
+    struct Format1 {
+        static constexpr uint8_t SECTOR_SIZE = NUM_SAMPLES * 2 + 1; // 57
+        static constexpr uint16_t PTR_ADDR = 0;
+        static constexpr uint16_t TEMP_ADDR = 1;
+        static constexpr uint16_t HUM_ADDR = 1 + NUM_SAMPLES;
+        static constexpr uint16_t PROBE_TEMP_ADDR = SECTOR_SIZE + TEMP_ADDR;  // 58
+        static constexpr uint16_t PROBE_HUM_ADDR = SECTOR_SIZE + HUM_ADDR;    // 86
+        static constexpr uint16_t TRACE_ADDR = 2 * SECTOR_SIZE;              // 114
+        static constexpr uint16_t TELEMETRY_ADDR = 3 * SECTOR_SIZE;          // 171
+        static constexpr uint16_t VOLTAGE_ADDR = 4 * SECTOR_SIZE;            // 228
+    };
+
+    // encoding ranges, values outside are clamped
+    static constexpr float MAX_TEMP = 60.0f;
+    static constexpr float MIN_TEMP = -50.0f;
+    static constexpr float MAX_HUM = 100.0f;
+    static constexpr float MIN_HUM = 0.0f;
+
+    // The sample channels, which are also the first cells of a record
+    enum Channel : uint8_t {
+        TEMPERATURE,
+        HUMIDITY,
+        PROBE_TEMPERATURE,
+        PROBE_HUMIDITY
+    };
+
+    static constexpr uint8_t VOLTAGE_CELL = 4; // the record cell after the channels
+
+    /** Address of the record in ring slot `slot` (0-27). */
+    static constexpr uint16_t recordAddr(uint8_t slot) {
+      return slot / RECORDS_PER_PAGE * PAGE_SIZE + slot % RECORDS_PER_PAGE * RECORD_SIZE;
+    }
+
+    static constexpr bool isTemperature(Channel channel) {
+      return channel == TEMPERATURE || channel == PROBE_TEMPERATURE;
+    }
+
+    // Scaled values are (value - channel minimum) * UNIT, exact integers for every cell: a cell is 1/255 of the
+    // channel's range, so one degree or %RH is 255
+    static constexpr uint16_t UNIT = 255;
+
+    /**
+     * The temperatures are floats but we store them as uint8_t in EEPROM. Do the conversion to some precision here.
+     *
+     * @param temperature The temperature value to encode, as a float.
+     * @return  Encoded temperature value as uint8_t.
+     */
+    static inline uint8_t encodeTemp(float temperature) {
+      // clamp the value to the encoding range
+      if (temperature < MIN_TEMP) temperature = MIN_TEMP;
+      if (temperature > MAX_TEMP) temperature = MAX_TEMP;
+
+      // scale to 0-255 range as a float
+      float scaled = (temperature - MIN_TEMP) * 255.0f / (MAX_TEMP - MIN_TEMP) + 0.5f;
+      // return as uint8_t
+      return static_cast<uint8_t>(scaled);
+    }
+
+    /**
+     * Decode an EEPROM temperature value to float.
+     * @param encodedTemp The encoded temperature value as uint8_t.
+     * @return Decoded temperature value as float.
+     */
+    static inline float decodeTemp(uint8_t encodedTemp) {
+      if (encodedTemp == EMPTY) return 0.0f; // handle special case for 0xFF
+
+      return (encodedTemp * (MAX_TEMP - MIN_TEMP) / 255.0f) + MIN_TEMP; // return the decoded temperature
+    }
+
+    /**
+     * The humidities are floats but we store them as uint8_t in EEPROM. Do the conversion to some precision here.
+     *
+     * @param humidity The humidity value to encode, as a float.
+     * @return  Encoded humidity value as uint8_t.
+     */
+    static inline uint8_t encodeHum(float humidity) {
+      // clamp the value to the encoding range
+      if (humidity < MIN_HUM) humidity = MIN_HUM;
+      if (humidity > MAX_HUM) humidity = MAX_HUM;
+
+      // scale to 0-255 range as a float
+      float scaledHum = (humidity - MIN_HUM) * 255.0f / (MAX_HUM - MIN_HUM) + 0.5f;
+      // return as uint8_t
+      return static_cast<uint8_t>(scaledHum);
+    }
+
+    /**
+     * Decode an EEPROM humidity value to float.
+     * @param encodedHum The encoded humidity value as uint8_t.
+     * @return Decoded humidity value as float.
+     */
+    static inline float decodeHum(uint8_t encodedHum) {
+      if (encodedHum == EMPTY) return 0.0f; // handle special case for 0xFF
+
+      return (encodedHum * (MAX_HUM - MIN_HUM) / 255.0f) + MIN_HUM; // return the decoded humidity
+    }
+
+    /**
+     * The lowest value of a channel's encoding range, in degrees or %RH.
+     */
+    static constexpr int16_t channelMin(Channel channel) {
+      return isTemperature(channel) ? (int16_t) MIN_TEMP : (int16_t) MIN_HUM;
+    }
+
+    /**
+     * Scale an EEPROM cell for integer arithmetic, without decoding it to float.
+     * @param channel The channel the cell belongs to.
+     * @param encoded The encoded value as uint8_t.
+     * @return (value - channelMin) * UNIT, with EMPTY scaled as 0 like decodeTemp/decodeHum do.
+     */
+    static inline uint16_t scaled(Channel channel, uint8_t encoded) {
+      if (encoded == EMPTY) return (uint16_t) (-channelMin(channel) * UNIT);
+      return encoded * (isTemperature(channel) ? (uint8_t) (MAX_TEMP - MIN_TEMP) : (uint8_t) (MAX_HUM - MIN_HUM));
+    }
+
+    /**
+     * Encode a battery voltage in 10 mV steps from 1.8 V, clamped to the range.
+     * @param millivolts The voltage in mV, 0 if it was not measured.
+     * @return Encoded voltage, EMPTY for 0.
+     */
+    static inline uint8_t encodeVoltage(uint16_t millivolts) {
+      if (millivolts == 0) return EMPTY;
+      if (millivolts < MIN_MILLIVOLTS) millivolts = MIN_MILLIVOLTS;
+      uint16_t steps = (millivolts - MIN_MILLIVOLTS + MILLIVOLT_STEP / 2) / MILLIVOLT_STEP;
+      return steps >= EMPTY ? EMPTY - 1 : (uint8_t) steps;
+    }
+
+    /**
+     * Decode an EEPROM voltage value.
+     * @param encodedVoltage The encoded voltage as uint8_t.
+     * @return The voltage in mV, 0 for an empty cell.
+     */
+    static inline uint16_t decodeVoltage(uint8_t encodedVoltage) {
+      if (encodedVoltage == EMPTY) return 0;
+      return MIN_MILLIVOLTS + encodedVoltage * MILLIVOLT_STEP;
+    }
+};
+
+static_assert(LoggerCodec::RECORDS_PER_PAGE * LoggerCodec::RECORD_SIZE <= LoggerCodec::PTR_OFFSET,
+              "a page's records must end before its front pointer");
+
+#endif //TEMPERATURETRACKER_LOGGERCODEC_H
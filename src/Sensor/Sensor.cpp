@@ -7,84 +7,76 @@
 #ifdef MAIN_BOARD
 
 #include "Sensor.h"
-#include <Wire.h>
+#include "Trace/Trace.h"
+#include "Telemetry/Telemetry.h"
+#include "Clock/Clock.h"
+#include "Hal/Isolation.h"
 
 /**
- * Write a single byte value to a BME280 register.
+ * Check if BME280 is responding and ready. Failed reads are retried while the wake's retry budget lasts, once it
+ * is spent a single read decides.
  */
-void Sensor::writeRegister(uint8_t reg, uint8_t val) {
-  Wire.beginTransmission(BME280_ADDR);
-  Wire.write(reg);
-  Wire.write(val);
-  Wire.endTransmission();
-}
-
-/**
- * Read an 8-bit unsigned value from the BME280.
- */
-uint8_t Sensor::read8(uint8_t reg) {
-  Wire.beginTransmission(BME280_ADDR);
-  Wire.write(reg);
-  Wire.endTransmission();
-  Wire.requestFrom(BME280_ADDR, 1);
-  return Wire.read();
-}
-
-/**
- * Read a 16-bit unsigned value (LSB first) from the BME280.
- */
-uint16_t Sensor::read16(uint8_t reg) {
-  Wire.beginTransmission(BME280_ADDR);
-  Wire.write(reg);
-  Wire.endTransmission();
-  Wire.requestFrom(BME280_ADDR, 2);
-  uint16_t val = Wire.read();
-  val |= (Wire.read() << 8);
-  return val;
+template<typename BusT>
+bool SensorT<BusT>::isReady() {
+  // Try to read chip ID register (should return 0x60)
+  while (true) {
+    uint8_t chipId;
+    if (BusT::readRegisters(address, 0xD0, &chipId, 1) && chipId == 0x60) {
+      return true;
+    }
+    if (!retriesLeft) return false;
+    retriesLeft--;
+    Telemetry::countReadyRetry();
+    Clock::idle(RETRY_IDLE_MS);
+  }
 }
 
 /**
- * Read a 16-bit signed value from the BME280.
+ * Reads the BME280's factory calibration coefficients into class variables.
  */
-int16_t Sensor::readS16(uint8_t reg) {
-  return (int16_t) read16(reg);
+template<typename BusT>
+void SensorT<BusT>::readCalibrationData() {
+  uint8_t t[6], h[7];
+  BusT::readRegisters(address, 0x88, t, sizeof(t));
+  BusT::readRegisters(address, 0xE1, h, sizeof(h));
+  setCalibration(t, read8(0xA1), h);
 }
 
 /**
- * Check if BME280 is responding and ready
+ * Decode the calibration registers.
+ *
+ * @param t  Registers 0x88-0x8D.
+ * @param h1 Register 0xA1.
+ * @param h  Registers 0xE1-0xE7.
  */
-bool Sensor::isReady() {
-  // Try to read chip ID register (should return 0x60)
-  for (int attempts = 0; attempts < 5; attempts++) {
-    uint8_t chipId = read8(0xD0);
-    if (chipId == 0x60) {
-      return true;
-    }
-    delay(10);
-  }
-  return false;
+void SensorBase::setCalibration(const uint8_t *t, uint8_t h1, const uint8_t *h) {
+  // high bytes are widened to uint16_t first: shifted as the AVR's 16-bit int they would overflow from 0x80 up
+  dig_T1 = t[0] | ((uint16_t) t[1] << 8);
+  dig_T2 = (int16_t) (t[2] | ((uint16_t) t[3] << 8));
+  dig_T3 = (int16_t) (t[4] | ((uint16_t) t[5] << 8));
+
+  dig_H1 = h1;
+  dig_H2 = (int16_t) (h[0] | ((uint16_t) h[1] << 8));
+  dig_H3 = h[2];
+  dig_H4 = (h[3] << 4) | (h[4] & 0x0F);
+  dig_H5 = (h[5] << 4) | (h[4] >> 4);
+  dig_H6 = (int8_t) h[6];
 }
 
 /**
- * Reads the BME280's factory calibration coefficients into class variables.
+ * Read one raw calibration register, for exporting the calibration alongside the history.
+ *
+ * @param index 0-25 map to 0x88-0xA1, 26-32 to 0xE1-0xE7.
  */
-void Sensor::readCalibrationData() {
-  dig_T1 = read16(0x88);
-  dig_T2 = readS16(0x8A);
-  dig_T3 = readS16(0x8C);
-
-  dig_H1 = read8(0xA1);
-  dig_H2 = readS16(0xE1);
-  dig_H3 = read8(0xE3);
-  dig_H4 = (read8(0xE4) << 4) | (read8(0xE5) & 0x0F);
-  dig_H5 = (read8(0xE6) << 4) | (read8(0xE5) >> 4);
-  dig_H6 = (int8_t) read8(0xE7);
+template<typename BusT>
+uint8_t SensorT<BusT>::readCalibrationRegister(uint8_t index) {
+  return read8(index < 26 ? 0x88 + index : 0xE1 + (index - 26));
 }
 
 /**
  * Applies the Bosch BME280 temperature compensation formula.
  */
-int32_t Sensor::compensateTemperature(int32_t adc_T) {
+int32_t SensorBase::compensateTemperature(int32_t adc_T) {
   int32_t var1 = ((((adc_T >> 3) - ((int32_t) dig_T1 << 1))) *
                   ((int32_t) dig_T2)) >> 11;
 
@@ -99,7 +91,7 @@ int32_t Sensor::compensateTemperature(int32_t adc_T) {
 /**
  * Applies the Bosch BME280 humidity compensation formula.
  */
-uint32_t Sensor::compensateHumidity(int32_t adc_H) {
+uint32_t SensorBase::compensateHumidity(int32_t adc_H) {
   int32_t v_x1 = t_fine - 76800;
 
   v_x1 = (((((adc_H << 14) - (((int32_t) dig_H4) << 20) -
@@ -117,114 +109,222 @@ uint32_t Sensor::compensateHumidity(int32_t adc_H) {
 /**
  * Enhanced initialization with better error handling
  */
-void Sensor::setup() {
-  Wire.begin();
-  delay(200); // Increased startup delay
+template<typename BusT>
+void SensorT<BusT>::setup() {
+  SensorT *self = this;
+  setupAll(&self, 1);
+}
+
+/**
+ * Set up sensors sharing the bus, waiting out their start up and first conversions once for all of them.
+ *
+ * @param sensors  The sensors, on distinct addresses.
+ * @param count    How many there are, at most 8.
+ * @param optional How many of the last ones may not be fitted.
+ * @return How many sensors were set up, from the front of sensors.
+ */
+template<typename BusT>
+uint8_t SensorT<BusT>::setupAll(SensorT *const *sensors, uint8_t count, uint8_t optional) {
+  uint16_t startup = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    sensors[i]->retriesLeft = RETRY_BUDGET;
+    sensors[i]->resetUsed = false;
+    if (sensors[i]->startupTime() > startup) startup = sensors[i]->startupTime();
+  }
+  BusT::begin();
+  // Start up wait of twice the slowest profile's startupTime(): 20 ms on ultra-low-power, 200 ms otherwise, where the
+  // BME280 needs 2 ms. The sensors share the latched rail with the MCU, so whatever the wake did before this (an
+  // EEPROM reset, drawing the last logged sample) counts towards it.
+  unsigned long elapsed = millis();
+  if (elapsed < startup * 2UL) Clock::idle(startup * 2 - elapsed);
+
+  // only now can a missing sensor be told from one still starting up
+  uint8_t found = count - optional;
+  while (found < count && sensors[found]->present()) found++;
+  count = found;
+
+  // each start() leaves a first forced conversion running
+  uint8_t conversionMs = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    if (sensors[i]->start() && sensors[i]->settings().conversionMs > conversionMs) {
+      conversionMs = sensors[i]->settings().conversionMs;
+    }
+  }
+  Clock::idle(conversionMs);
+  return count;
+}
+
+/**
+ * Check a BME280 answers at this address, with the bus's own attempts but no retry budget or reset, so looking
+ * for a sensor that is not fitted stays cheap.
+ */
+template<typename BusT>
+bool SensorT<BusT>::present() {
+  BusT::begin();
+  uint8_t chipId;
+  return BusT::readRegisters(address, 0xD0, &chipId, 1) && chipId == 0x60;
+}
 
-  // Verify sensor is responding
+/**
+ * Verify the sensor is responding, soft resetting it once per wake if it is not, then load the calibration and
+ * the profile.
+ *
+ * @return False if the sensor did not answer; it is left unconfigured.
+ */
+template<typename BusT>
+bool SensorT<BusT>::start() {
   if (!isReady()) {
     // If sensor not ready, try full reset sequence
+    if (resetUsed) return false;
     reset();
-    delay(100);
+    Clock::idle(100);
     if (!isReady()) {
       // Still not ready - this is a problem
-      return;
+      return false;
     }
   }
 
   readCalibrationData();
+  configure();
+  return true;
+}
 
-  // Set humidity oversampling ×1
-  writeRegister(0xF2, 0x01);
-  // Set temperature oversampling ×1 and forced mode
-  writeRegister(0xF4, 0x25);
-
-  // Wait for initial measurement to complete
-  delay(100);
+/**
+ * Write the profile's filter and oversampling settings and run a first forced conversion.
+ */
+template<typename BusT>
+void SensorT<BusT>::configure() {
+  // config is only written reliably in sleep mode, and ctrl_hum only takes effect with the ctrl_meas write after it
+  writeRegister(0xF5, settings().config);
+  writeRegister(0xF2, settings().ctrlHum);
+  writeRegister(0xF4, settings().ctrlMeas); // starts a first forced conversion, the caller waits for it
 }
 
 /**
  * Enhanced reset with better timing
  */
-void Sensor::reset() {
+template<typename BusT>
+void SensorT<BusT>::reset() {
   // Send software reset command
+  resetUsed = true;
+  Telemetry::countSensorReset();
   writeRegister(0xE0, 0xB6);
-  delay(500); // Increased reset delay
+  Clock::idle(500); // Increased reset delay
 }
 
 /**
  * Enhanced wake function for post-sleep initialization
  */
-void Sensor::wake() {
+template<typename BusT>
+void SensorT<BusT>::wake() {
   // Re-initialize I2C
-  Wire.begin();
-  delay(100);
+  BusT::begin();
+  Clock::idle(startupTime());
 
-  // Check if sensor is responding
-  if (!isReady()) {
-    // Try reset if not responding
-    reset();
-    delay(100);
-    if (!isReady()) {
-      return; // Sensor not responding
-    }
-  }
+  // Re-read calibration data (may have been lost) and reconfigure sensor, if it is responding
+  if (start()) Clock::idle(settings().conversionMs); // Wait for initial measurement to complete
+}
 
-  // Re-read calibration data (may have been lost)
-  readCalibrationData();
+/**
+ * Enhanced data reading with validation
+ */
+template<typename BusT>
+SensorBase::Data SensorT<BusT>::readData() {
+  SensorT *self = this;
+  Data result;
+  readAll(&self, &result, 1);
+  return result;
+}
+
+/**
+ * Read sensors sharing the bus in about the time of one conversion.
+ *
+ * @param sensors The sensors, on distinct addresses.
+ * @param results One reading per sensor, zeros for a sensor that did not respond.
+ * @param count   How many there are, at most 8.
+ */
+template<typename BusT>
+void SensorT<BusT>::readAll(SensorT *const *sensors, Data *results, uint8_t count) {
+  TRACE(TRACE_SENSOR_READ_BEGIN);
+
+  // Trigger every forced measurement before waiting for any
+  uint8_t triggered = 0;
+  uint8_t conversionMs = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    if (!sensors[i]->trigger()) continue;
+    triggered |= 1 << i;
+    if (sensors[i]->settings().conversionMs > conversionMs) conversionMs = sensors[i]->settings().conversionMs;
+  }
+  Clock::idle(conversionMs); // the status polls cover any shortfall
 
-  // Reconfigure sensor
-  writeRegister(0xF2, 0x01); // Humidity oversampling
-  writeRegister(0xF4, 0x25); // Temperature oversampling + forced mode
+  for (uint8_t i = 0; i < count; i++) {
+    // Return error values for a sensor that could not be triggered
+    results[i] = (triggered & (1 << i)) ? sensors[i]->collect() : Data{.temperature = 0.0f, .humidity = 0.0f};
+  }
 
-  delay(100);
+  TRACE(TRACE_SENSOR_READ_END);
 }
 
 /**
- * Enhanced data reading with validation
+ * Make sure the sensor is responding and start a forced measurement.
+ *
+ * @return False if it is not responding.
  */
-Sensor::Data Sensor::readData() {
+template<typename BusT>
+bool SensorT<BusT>::trigger() {
   // Check sensor is ready before reading
   if (!isReady()) {
-    // Try to wake/reinitialize
-    wake();
-    if (!isReady()) {
-      // Return error values
-      return {.temperature = 0.0f, .humidity = 0.0f};
+    // Try to wake/reinitialize, unless this wake's reset was already spent on it
+    bool awake = false;
+    if (!resetUsed) {
+      wake();
+      awake = isReady();
+    }
+    if (!awake) {
+      return false;
     }
   }
 
   // Trigger forced measurement
-  writeRegister(0xF4, 0x25);
-  delay(100); // Increased conversion delay
+  writeRegister(0xF4, settings().ctrlMeas);
+  return true;
+}
 
+/**
+ * Wait for the triggered measurement to complete and read it with one burst.
+ */
+template<typename BusT>
+SensorBase::Data SensorT<BusT>::collect() {
   // Check measurement is complete
-  uint8_t status = read8(0xF3);
+  uint8_t status = 0x08;
   int timeout = 0;
   while ((status & 0x08) && timeout < 10) { // Wait for measurement complete
-    delay(10);
-    status = read8(0xF3);
-    timeout++;
+    if (timeout++) Clock::idle(10);
+    if (!BusT::readRegisters(address, 0xF3, &status, 1)) break; // the data read below fails too
   }
 
   // Read sensor data
-  Wire.beginTransmission(BME280_ADDR);
-  Wire.write(0xF7);
-  Wire.endTransmission();
-  Wire.requestFrom(BME280_ADDR, 8);
+  uint8_t data[DATA_SIZE];
+  Data result = {.temperature = 0.0f, .humidity = 0.0f};
+  if (BusT::readRegisters(address, 0xF7, data, DATA_SIZE)) result = convert(data);
+  return result;
+}
 
-  // Skip pressure readings
-  Wire.read();
-  Wire.read();
-  Wire.read();
+/**
+ * Validate and compensate one burst of data registers.
+ *
+ * @param data Registers 0xF7-0xFE: pressure (skipped), temperature and humidity.
+ */
+SensorBase::Data SensorBase::convert(const uint8_t *data) {
+  // Skip pressure readings (data[0..2])
 
   // Read temperature
-  int32_t adc_T = ((uint32_t) Wire.read() << 12) |
-                  ((uint32_t) Wire.read() << 4) |
-                  (Wire.read() >> 4);
+  int32_t adc_T = ((uint32_t) data[3] << 12) |
+                  ((uint32_t) data[4] << 4) |
+                  (data[5] >> 4);
 
   // Read humidity
-  int32_t adc_H = ((uint32_t) Wire.read() << 8) | Wire.read();
+  int32_t adc_H = ((uint32_t) data[6] << 8) | data[7];
 
   // Validate readings (raw values shouldn't be 0x80000 or 0x8000)
   if (adc_T == 0x80000 || adc_H == 0x8000) {
@@ -250,10 +350,17 @@ Sensor::Data Sensor::readData() {
   return {.temperature = temperature, .humidity = humidity};
 }
 
-void Sensor::powerOff() {
-  // Put sensor in sleep mode before powering off
+/**
+ * Put the sensor in sleep mode before powering off. The bus is left running so the
+ * display can still be shut down after this; the caller releases it.
+ */
+template<typename BusT>
+void SensorT<BusT>::powerOff() {
   writeRegister(0xF4, 0x00); // Sleep mode
-  delay(10);
-  Wire.end();
 }
-#endif
\ No newline at end of file
+template class SensorT<WireBus>;
+#ifdef HAL_ISOLATION
+template class SensorT<RegisterBus>;
+#endif
+
+#endif
@@ -11,39 +11,133 @@
 
 
 #include "Arduino.h"
+#include "Hal/Avr.h"
 
 #define BME280_ADDR 0x76
+#define BME280_ADDR_PROBE 0x77 // SDO tied high: the second sensor, on the external lead
 
-class Sensor {
+/**
+ * The bus independent half of the sensor: profiles, calibration and the Bosch compensation.
+ */
+class SensorBase {
 public:
     struct Data {
         float temperature;
         float humidity;
     };
 
-    void setup();
-    void powerOff();
-    void wake();
-    bool isReady(); // New method to check sensor status
+    /** Measurement settings. Pressure is never converted, the firmware has no use for it. */
+    enum Profile : uint8_t {
+        PROFILE_ULTRA_LOW_POWER, // temperature and humidity ×1, no filter
+        PROFILE_INDOOR,          // temperature and humidity ×2, IIR filter 4
+        PROFILE_HIGH_PRECISION,  // temperature and humidity ×16, IIR filter 16
+        PROFILE_COUNT
+    };
 
-    Data readData();
+    /** Select the profile used from the next setup() or wake() on. */
+    void setProfile(Profile newProfile) { profile = newProfile; }
+
+    constexpr static uint8_t CALIBRATION_SIZE = 33; // raw registers 0x88-0xA1 and 0xE1-0xE7
+
+    // Retry budget of a wake, refilled by setup(): failed chip id reads before the sensor is given up on, and a
+    // single soft reset. With Bus::ATTEMPTS per register operation this bounds what a missing sensor or a stuck
+    // bus adds to a wake, instead of leaving it to the watchdog.
+    constexpr static uint8_t RETRY_BUDGET = 4;
+    constexpr static uint8_t RETRY_IDLE_MS = 10;
+
+protected:
+    friend class BenchmarkController; // benchmarks the private hot paths
 
-private:
     uint16_t dig_T1;
     int16_t dig_T2, dig_T3;
     uint16_t dig_H1, dig_H3;
     int16_t dig_H2, dig_H4, dig_H5;
     int8_t dig_H6;
     int32_t t_fine;
+    Profile profile = PROFILE_INDOOR; // before the profiles the sensor ran at ultra-low-power's ×1 and no filter
 
-    void writeRegister(uint8_t reg, uint8_t val);
-    uint8_t read8(uint8_t reg);
-    uint16_t read16(uint8_t reg);
-    int16_t readS16(uint8_t reg);
-    void readCalibrationData();
+    /** Register values of a profile and its datasheet maximum conversion time. */
+    struct ProfileSettings {
+        uint8_t ctrlHum;      // 0xF2: humidity oversampling
+        uint8_t ctrlMeas;     // 0xF4: temperature / pressure oversampling and forced mode
+        uint8_t config;       // 0xF5: IIR filter coefficient (it filters temperature only, not humidity)
+        uint8_t conversionMs; // 1.25 + 2.3 * osrs_t + 2.3 * osrs_h + 0.575 ms, rounded up
+    };
+    constexpr static ProfileSettings PROFILES[PROFILE_COUNT] = {
+        {0x01, 0x21, 0x00, 7},  // ultra-low-power
+        {0x02, 0x41, 0x08, 12}, // indoor
+        {0x05, 0xA1, 0x10, 76}, // high-precision
+    };
+
+    uint8_t retriesLeft = RETRY_BUDGET;
+    bool resetUsed = false;
+
+    const ProfileSettings &settings() const { return PROFILES[profile]; }
+    uint16_t startupTime() const { return profile == PROFILE_ULTRA_LOW_POWER ? 10 : 100; } // I2C / sensor settle
+
+    constexpr static uint8_t DATA_SIZE = 8; // pressure, temperature and humidity registers from 0xF7
+
+    /** Set the calibration from the raw registers 0x88-0x8D, 0xA1 and 0xE1-0xE7 (CALIBRATION_SIZE layout). */
+    void setCalibration(const uint8_t *t, uint8_t h1, const uint8_t *h);
+    Data convert(const uint8_t *data);
     int32_t compensateTemperature(int32_t adc_T);
     uint32_t compensateHumidity(int32_t adc_H);
+};
+
+/**
+ * The BME280 on an I2C bus (see Hal/Bus.h). The firmware uses Sensor, the one on the board's TWI.
+ */
+template<typename BusT>
+class SensorT : public SensorBase {
+public:
+    explicit SensorT(uint8_t address = BME280_ADDR) : address(address) {}
+
+    void setup();
+    void powerOff();
+    void wake();
+    bool isReady(); // New method to check sensor status, spends the retry budget
+
+    /**
+     * Whether a BME280 answers at this address at all, without spending the retry budget. Begins the bus; only ask
+     * once the start up wait is over (setupAll does), a sensor still starting up reads as absent.
+     */
+    bool present();
+
+    Data readData();
+
+    /**
+     * Set up several sensors on the bus with one start up wait and one wait for their first conversions.
+     * Sensors must be on distinct addresses; at most 8. The last `optional` of them may not be fitted: they are looked
+     * for with present() after the start up wait, in order, and the first that does not answer ends the list.
+     * Returns how many sensors were set up, counted from the front of `sensors`.
+     */
+    static uint8_t setupAll(SensorT *const *sensors, uint8_t count, uint8_t optional = 0);
+
+    /**
+     * Read several sensors together: their conversions are triggered back-to-back so they run at the same time,
+     * then each result is collected with one burst read. Takes about one conversion time, not one per sensor.
+     * Sensors that are not responding read as zeros, like readData() does.
+     */
+    static void readAll(SensorT *const *sensors, Data *results, uint8_t count);
+
+    uint8_t readCalibrationRegister(uint8_t index);
+
+private:
+    friend class BenchmarkController; // benchmarks the private hot paths
+
+    uint8_t address;
+
+    void writeRegister(uint8_t reg, uint8_t val) { BusT::writeRegister(address, reg, val); }
+    uint8_t read8(uint8_t reg) { return BusT::read8(address, reg); }
+    bool trigger();
+    Data collect();
+    bool start();
+    void readCalibrationData();
     void reset();
+    void configure();
 };
+
+using Sensor = SensorT<WireBus>;
+
 #endif
-#endif //TEMPSENSOR_SENSOR_H
\ No newline at end of file
+#endif //TEMPSENSOR_SENSOR_H
@@ -0,0 +1,71 @@
+#include "Telemetry.h"
+#include "Logger/Logger.h"
+#include <EEPROM.h>
+
+#ifdef MAIN_BOARD
+
+static_assert(sizeof(Telemetry::Block) <= LoggerCodec::TRACE_ADDR - LoggerCodec::TELEMETRY_ADDR,
+              "telemetry block must fit between the history and the trace summary");
+
+static constexpr uint16_t BLOCK_ADDR = LoggerCodec::TELEMETRY_ADDR;
+
+uint8_t Telemetry::readyRetries = 0;
+uint8_t Telemetry::sensorResets = 0;
+uint8_t Telemetry::busRecoveries = 0;
+uint16_t Telemetry::frames = 0;
+
+/**
+ * Add to a counter without wrapping.
+ */
+static void saturatingAdd(uint16_t &counter, uint16_t value) {
+  counter = (counter > 0xFFFF - value) ? 0xFFFF : counter + value;
+}
+
+/**
+ * Read the telemetry block, or an all-zero block if it has never been written.
+ *
+ * @param block Where to store the block.
+ */
+void Telemetry::read(Block &block) {
+  EEPROM.get(BLOCK_ADDR, block);
+  if (block.version != VERSION) {
+    memset(&block, 0, sizeof(block));
+    block.version = VERSION;
+  }
+}
+
+/**
+ * Fold this wake into the EEPROM block. Call once, just before power off.
+ *
+ * @param headless True if the wake came from the measurement pulse rather than the button.
+ * @param awakeMs  How long the device has been awake.
+ */
+void Telemetry::commit(bool headless, unsigned long awakeMs) {
+  Block block;
+  read(block);
+
+  uint8_t shift = headless ? HEADLESS_BUCKET_SHIFT : SESSION_BUCKET_SHIFT;
+  uint8_t bucket = 0;
+  for (unsigned long units = awakeMs >> shift; units && bucket < BUCKETS - 1; units >>= 1) bucket++;
+
+  if (headless) {
+    saturatingAdd(block.headlessWakes, 1);
+    saturatingAdd(block.headlessDuration[bucket], 1);
+  } else {
+    saturatingAdd(block.buttonWakes, 1);
+    saturatingAdd(block.sessionDuration[bucket], 1);
+  }
+  saturatingAdd(block.readyRetries, readyRetries);
+  saturatingAdd(block.sensorResets, sensorResets);
+  block.busRecoveries = (block.busRecoveries > 255 - busRecoveries) ? 255 : block.busRecoveries + busRecoveries;
+  block.framesDrawn = (block.framesDrawn > 0xFFFFFFFFUL - frames) ? 0xFFFFFFFFUL : block.framesDrawn + frames;
+
+  EEPROM.put(BLOCK_ADDR, block); // only the bytes that changed are written
+
+  readyRetries = 0;
+  sensorResets = 0;
+  busRecoveries = 0;
+  frames = 0;
+}
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef TEMPERATURETRACKER_TELEMETRY_H
+#define TEMPERATURETRACKER_TELEMETRY_H
+
+#include "Arduino.h"
+
+/**
+ * Telemetry – per-wake counters kept in EEPROM after the history for in-field energy profiling.
+ *
+ * The counters for the current wake live in RAM and are folded into the EEPROM block once, on power off.
+ * Read a unit's EEPROM image and decode it with tools/telemetry_decode.py.
+ */
+class Telemetry {
+public:
+    static constexpr uint8_t VERSION = 3; // bump when the block layout changes, resets the block
+    static constexpr uint8_t BUCKETS = 6; // wake duration histogram buckets
+
+    // Bucket i of a histogram counts wakes shorter than (1 << i) << shift ms, the last bucket everything longer.
+    static constexpr uint8_t HEADLESS_BUCKET_SHIFT = 9;  // 0.5 s, 1 s, 2 s, 4 s, 8 s, longer
+    static constexpr uint8_t SESSION_BUCKET_SHIFT = 12; // 4 s, 8 s, 16 s, 32 s, 64 s, longer
+
+    /**
+     * Layout of the EEPROM block, all counters saturate instead of wrapping.
+     * Fields are ordered so the layout has no padding on wider hosts either.
+     */
+    struct Block {
+        uint32_t framesDrawn;                // full display frames rendered
+        uint8_t version;
+        uint8_t busRecoveries;               // times a device held SDA low and WireBus::recover() clocked it free
+        uint16_t headlessWakes;              // wakes from the measurement pulse
+        uint16_t buttonWakes;                // wakes from the push button
+        uint16_t headlessDuration[BUCKETS];  // histogram of headless wake durations
+        uint16_t sessionDuration[BUCKETS];   // histogram of button session durations
+        uint16_t readyRetries;               // failed chip id reads in Sensor::isReady()
+        uint16_t sensorResets;               // soft resets of the BME280
+    };
+
+    static void countReadyRetry() { if (readyRetries < 255) readyRetries++; }
+
+    static void countSensorReset() { if (sensorResets < 255) sensorResets++; }
+
+    static void countBusRecovery() { if (busRecoveries < 255) busRecoveries++; }
+
+    static void countFrame() { if (frames < 0xFFFF) frames++; }
+
+    static void read(Block &block);
+
+    static void commit(bool headless, unsigned long awakeMs);
+
+private:
+    // counters for the current wake
+    static uint8_t readyRetries;
+    static uint8_t sensorResets;
+    static uint8_t busRecoveries;
+    static uint16_t frames;
+};
+
+#endif //TEMPERATURETRACKER_TELEMETRY_H
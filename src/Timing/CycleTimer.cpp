@@ -0,0 +1,72 @@
+// only the benchmark and trace builds time anything, so MainBoard gets neither the code nor the TCB0 vector
+#if defined(MAIN_BOARD) && (defined(BENCHMARK_BOARD) || defined(TRACE_ENABLED))
+
+#include "CycleTimer.h"
+
+#if defined(MILLIS_USE_TIMERB0)
+#error "CycleTimer needs TCB0, select a different millis timer in the core options"
+#endif
+
+static volatile uint16_t overflows = 0; // upper 16 bits of the cycle count
+
+ISR(TCB0_INT_vect) {
+  TCB0.INTFLAGS = TCB_CAPT_bm;
+  overflows++;
+}
+
+/**
+ * Start TCB0 as a 16-bit periodic counter on CLK_PER and count its overflows.
+ */
+void CycleTimer::begin() {
+  TCB0.CTRLA = 0;
+  TCB0.CTRLB = TCB_CNTMODE_INT_gc; // periodic interrupt mode
+  TCB0.CCMP = 0xFFFF;              // full 16-bit period
+  TCB0.CNT = 0;
+  TCB0.INTFLAGS = TCB_CAPT_bm;
+  TCB0.INTCTRL = TCB_CAPT_bm;
+  overflows = 0;
+  TCB0.CTRLA = TCB_CLKSEL_CLKDIV1_gc | TCB_ENABLE_bm;
+}
+
+/**
+ * Stop the counter so it no longer draws current or raises interrupts.
+ */
+void CycleTimer::end() {
+  TCB0.CTRLA = 0;
+  TCB0.INTCTRL = 0;
+}
+
+/**
+ * Read the current 32-bit cycle count.
+ *
+ * @return Cycles of CLK_PER since begin().
+ */
+uint32_t CycleTimer::now() {
+  uint8_t sreg = SREG;
+  cli();
+  uint16_t low = TCB0.CNT;
+  uint16_t high = overflows;
+  // an overflow that happened after cli() has not been counted yet
+  if ((TCB0.INTFLAGS & TCB_CAPT_bm) && low < 0x8000) high++;
+  SREG = sreg;
+  return ((uint32_t) high << 16) | low;
+}
+
+/**
+ * Add cycles to the count. The few cycles TCB0 is stopped for are lost.
+ *
+ * @param cycles Cycles to add.
+ */
+void CycleTimer::advance(uint32_t cycles) {
+  uint8_t sreg = SREG;
+  cli();
+  TCB0.CTRLA &= ~TCB_ENABLE_bm; // stopped, so it cannot overflow while it is rewritten
+  uint32_t target = now() + cycles;
+  TCB0.CNT = (uint16_t) target;
+  TCB0.INTFLAGS = TCB_CAPT_bm; // now() counted a pending overflow already
+  overflows = target >> 16;
+  TCB0.CTRLA |= TCB_ENABLE_bm;
+  SREG = sreg;
+}
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef TEMPERATURETRACKER_CYCLETIMER_H
+#define TEMPERATURETRACKER_CYCLETIMER_H
+
+#ifdef MAIN_BOARD
+
+#include "Arduino.h"
+
+/**
+ * CycleTimer – free running CPU cycle counter built on TCB0.
+ *
+ * TCB0 counts CLK_PER and an overflow interrupt extends it to 32 bits, which wraps after ~214 s at 20 MHz.
+ * That is far longer than any wake, so differences of two now() calls are always valid.
+ */
+class CycleTimer {
+public:
+    static void begin();
+
+    static void end();
+
+    static uint32_t now();
+
+    /** Move the count on, for time TCB0 spent counting a slowed CLK_PER (see Clock::idle). */
+    static void advance(uint32_t cycles);
+
+    /** Convert a cycle count to microseconds at the current F_CPU. */
+    static uint32_t toMicros(uint32_t cycles) { return cycles / (F_CPU / 1000000UL); }
+};
+
+#endif // MAIN_BOARD
+
+#endif //TEMPERATURETRACKER_CYCLETIMER_H
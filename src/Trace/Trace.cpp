@@ -0,0 +1,62 @@
+#ifdef TRACE_ENABLED
+
+#include "Trace.h"
+#include "Timing/CycleTimer.h"
+#include "Logger/Logger.h"
+#include <EEPROM.h>
+
+static_assert((Trace::DEPTH & (Trace::DEPTH - 1)) == 0, "Trace::DEPTH must be a power of two");
+static_assert(LoggerCodec::TRACE_ADDR + 2 + Trace::EEPROM_ENTRIES * 3 <= LoggerCodec::FORMAT_ADDR,
+              "trace summary must end before the format marker");
+
+Trace::Entry Trace::ring[Trace::DEPTH];
+uint8_t Trace::head = 0;
+uint8_t Trace::recorded = 0;
+
+/**
+ * Start the timestamp counter. Call this first thing in setup().
+ */
+void Trace::begin() {
+  CycleTimer::begin();
+  head = 0;
+  recorded = 0;
+}
+
+/**
+ * Record one event, overwriting the oldest entry once the ring is full.
+ *
+ * @param event The event that just happened.
+ */
+void Trace::record(TraceEvent event) {
+  Entry &entry = ring[head & (DEPTH - 1)];
+  entry.cycles = CycleTimer::now();
+  entry.event = event;
+  head++;
+  if (recorded < 255) recorded++;
+}
+
+/**
+ * Write the newest events to EEPROM, from LoggerCodec::TRACE_ADDR.
+ *
+ * Layout: [0] entries stored, [1] events recorded this wake (saturating),
+ * then per entry (oldest → newest) the event id and a little-endian uint16 timestamp in ms.
+ */
+void Trace::flush() {
+  uint8_t stored = recorded;
+  if (stored > DEPTH) stored = DEPTH;
+  if (stored > EEPROM_ENTRIES) stored = EEPROM_ENTRIES;
+
+  uint16_t addr = LoggerCodec::TRACE_ADDR;
+  EEPROM.update(addr++, stored);
+  EEPROM.update(addr++, recorded);
+
+  for (uint8_t i = 0; i < stored; i++) {
+    const Entry &entry = ring[(uint8_t) (head - stored + i) & (DEPTH - 1)];
+    uint16_t ms = entry.cycles / (F_CPU / 1000UL);
+    EEPROM.update(addr++, entry.event);
+    EEPROM.update(addr++, ms & 0xFF);
+    EEPROM.update(addr++, ms >> 8);
+  }
+}
+
+#endif
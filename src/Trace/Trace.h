@@ -0,0 +1,75 @@
+#ifndef TEMPERATURETRACKER_TRACE_H
+#define TEMPERATURETRACKER_TRACE_H
+
+#include "Arduino.h"
+
+/**
+ * Hot path trace events. tools/trace_decode.py reads the names from this enum, so append new events at the end
+ * and keep the one-per-line layout.
+ */
+enum TraceEvent : uint8_t {
+    TRACE_SETUP_BEGIN,
+    TRACE_SETUP_END,
+    TRACE_LOOP_BUTTON,
+    TRACE_LOOP_DISPLAY_UPDATE,
+    TRACE_MEASUREMENT_BEGIN,
+    TRACE_MEASUREMENT_END,
+    TRACE_SENSOR_READ_BEGIN,
+    TRACE_SENSOR_READ_END,
+    TRACE_LOGGER_PUSH_BEGIN,
+    TRACE_LOGGER_PUSH_END,
+    TRACE_DISPLAY_MAIN_BEGIN,
+    TRACE_DISPLAY_MAIN_END,
+    TRACE_DISPLAY_CHART_BEGIN,
+    TRACE_DISPLAY_CHART_END,
+    TRACE_POWER_OFF,
+};
+
+#ifdef TRACE_ENABLED
+
+/**
+ * Trace – RAM ring of the most recent hot path events, timestamped with CycleTimer.
+ *
+ * Build with -D TRACE_ENABLED (the Trace env) to use it, otherwise the TRACE macros compile to nothing.
+ * With -D TRACE_FLUSH_EEPROM the newest events are also written to EEPROM after the telemetry block on power off,
+ * where tools/trace_decode.py can turn them into a timeline. That adds up to 53 EEPROM writes to every wake.
+ */
+class Trace {
+public:
+    static constexpr uint8_t DEPTH = 32; // entries in the RAM ring, must be a power of two
+    static constexpr uint8_t EEPROM_ENTRIES = 17; // entries that fit before the format marker, see Logger.h
+
+    static void begin();
+
+    static void record(TraceEvent event);
+
+    static void flush();
+
+private:
+    struct Entry {
+        TraceEvent event;
+        uint32_t cycles; // CycleTimer::now() when the event happened
+    };
+
+    static Entry ring[DEPTH];
+    static uint8_t head; // index of the next entry to write
+    static uint8_t recorded; // events recorded this wake, saturates at 255
+};
+
+#define TRACE_BEGIN() Trace::begin()
+#define TRACE(event) Trace::record(event)
+#ifdef TRACE_FLUSH_EEPROM
+#define TRACE_FLUSH() Trace::flush()
+#else
+#define TRACE_FLUSH() ((void) 0)
+#endif
+
+#else
+
+#define TRACE_BEGIN() ((void) 0)
+#define TRACE(event) ((void) 0)
+#define TRACE_FLUSH() ((void) 0)
+
+#endif // TRACE_ENABLED
+
+#endif //TEMPERATURETRACKER_TRACE_H
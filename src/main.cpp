@@ -1,15 +1,22 @@
 #include "Arduino.h"
 
 
+// The controller is a static object of its concrete type, so setup() and loop() are direct (inlinable) calls
+// and nothing is allocated on the heap.
+#ifdef BENCHMARK_BOARD
+#include "Controllers/BenchmarkController.h"
+static BenchmarkController controller;
+#else
 #include "Controllers/MainController.h"
-Controller *controller = new MainController();
+static MainController controller;
+#endif
 
 
 void setup() {
-  controller->setup();
+  controller.setup();
 }
 
 
 void loop() {
-  controller->loop();
+  controller.loop();
 }
@@ -0,0 +1,77 @@
+#!/usr/bin/env python3
+"""
+Parse and compare BenchmarkController runs.
+
+Capture a run with e.g. `pio device monitor -e Benchmark > run.txt`, then:
+
+    bench_diff.py run.txt                    print the results of one run
+    bench_diff.py base.txt new.txt           compare two runs
+    bench_diff.py base.txt new.txt --fail 5  also exit 1 if any benchmark got more than 5% slower
+"""
+
+import argparse
+import sys
+
+
+def parse(path):
+    """Return (f_cpu, {name: cycles_per_iteration}) for the last complete run in a capture."""
+    f_cpu = None
+    results = {}
+    complete = None
+    with open(path, errors="replace") as f:
+        for line in f:
+            fields = line.strip().split(",")
+            if fields[0] == "BENCH_BEGIN" and len(fields) == 2:
+                f_cpu = int(fields[1])
+                results = {}
+            elif fields[0] == "BENCH" and len(fields) == 5:
+                results[fields[1]] = int(fields[4])
+            elif fields[0] == "BENCH_END":
+                complete = (f_cpu, results)
+    if complete is None:
+        sys.exit(f"{path}: no complete BENCH_BEGIN..BENCH_END run found")
+    return complete
+
+
+def us(cycles, f_cpu):
+    return cycles * 1e6 / f_cpu
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("base")
+    parser.add_argument("new", nargs="?")
+    parser.add_argument("--fail", type=float, metavar="PCT",
+                        help="exit with status 1 if any benchmark regresses by more than PCT percent")
+    args = parser.parse_args()
+
+    base_cpu, base = parse(args.base)
+    if args.new is None:
+        print(f"{'benchmark':<26}{'cycles/iter':>14}{'us/iter':>12}")
+        for name, cycles in base.items():
+            print(f"{name:<26}{cycles:>14}{us(cycles, base_cpu):>12.1f}")
+        return 0
+
+    new_cpu, new = parse(args.new)
+    if new_cpu != base_cpu:
+        print(f"warning: F_CPU differs ({base_cpu} vs {new_cpu}), cycle counts are not comparable", file=sys.stderr)
+
+    regressions = []
+    print(f"{'benchmark':<26}{'base':>12}{'new':>12}{'delta':>9}")
+    for name in list(base) + [n for n in new if n not in base]:
+        if name not in base or name not in new:
+            print(f"{name:<26}{base.get(name, '-'):>12}{new.get(name, '-'):>12}{'':>9}")
+            continue
+        delta = (new[name] - base[name]) * 100.0 / base[name] if base[name] else 0.0
+        print(f"{name:<26}{base[name]:>12}{new[name]:>12}{delta:>+8.1f}%")
+        if args.fail is not None and delta > args.fail:
+            regressions.append(name)
+
+    if regressions:
+        print(f"regressed by more than {args.fail}%: {', '.join(regressions)}", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
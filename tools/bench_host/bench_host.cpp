@@ -0,0 +1,92 @@
+/*
+ * bench_host: BenchmarkController on the simulated board, with host instruction counts in place of cycles.
+ *
+ * The real BenchmarkController runs in a child process that this one single steps with ptrace between
+ * CycleTimer::begin() and end() (see host/HostCycleTimer.cpp), so every benchmark reports the x86 instructions it
+ * executed. The output has the on-target format, so bench_diff.py compares it with the checked-in baseline:
+ *
+ *   build-tools/bench_host > run.txt && tools/bench_diff.py tools/bench_host_baseline.txt run.txt --fail 2
+ *
+ * which is what the bench_gate target runs. Counts are deterministic for one build, but depend on the compiler and
+ * its flags, so regenerate the baseline (redirect this tool's output to it) when the toolchain changes. They rank
+ * and track the code's own work; they are not AVR cycles. The *_isolated and the pure compute benchmarks measure
+ * firmware code only, the others also count the host simulation of the bus, EEPROM or panel.
+*/
+
+#include <cstdio>
+#include <cstdint>
+#include <signal.h>
+#include <sys/ptrace.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "Arduino.h"
+#include "HostBoard.h"
+#include "Controllers/BenchmarkController.h"
+
+extern volatile uint64_t hostInstructions;
+
+namespace {
+
+    int noInputs(uint8_t, uint64_t, void *) { return -1; }
+
+    [[noreturn]] void runBenchmarks() {
+      if (ptrace(PTRACE_TRACEME, 0, nullptr, nullptr) != 0) _exit(3);
+      raise(SIGSTOP); // wait for the tracer
+
+      host::Board &board = host::Board::get();
+      board.sensor.setEnvironment(21.0, 45.0);
+      board.powerOn(noInputs, nullptr);
+      board.serialFd = STDOUT_FILENO;
+      BenchmarkController controller;
+      controller.setup();
+      _exit(0);
+    }
+
+    /** Single step the child between the CycleTimer markers and answer its now() calls. */
+    int trace(pid_t child) {
+      bool stepping = false;
+      uint64_t count = 0;
+      while (true) {
+        int status;
+        if (waitpid(child, &status, 0) < 0) {
+          perror("waitpid");
+          return 1;
+        }
+        if (WIFEXITED(status)) return WEXITSTATUS(status);
+        if (WIFSIGNALED(status)) {
+          fprintf(stderr, "benchmarks killed by signal %d\n", WTERMSIG(status));
+          return 1;
+        }
+
+        int deliver = 0;
+        int signal = WSTOPSIG(status);
+        if (signal == SIGTRAP && stepping) {
+          count++;
+        } else if (signal == SIGUSR1) {
+          if (!stepping) count = 0;
+          stepping = true;
+          ptrace(PTRACE_POKEDATA, child, (void *) &hostInstructions, (void *) count);
+        } else if (signal == SIGUSR2) {
+          stepping = false;
+        } else if (signal != SIGSTOP) {
+          deliver = signal;
+        }
+        if (ptrace(stepping ? PTRACE_SINGLESTEP : PTRACE_CONT, child, nullptr, (void *) (intptr_t) deliver) != 0) {
+          perror("ptrace");
+          return 1;
+        }
+      }
+    }
+
+}
+
+int main() {
+  fflush(stdout);
+  pid_t child = fork();
+  if (child < 0) {
+    perror("fork");
+    return 1;
+  }
+  if (child == 0) runBenchmarks();
+  return trace(child);
+}
@@ -0,0 +1,111 @@
+/*
+ * bus_faults: what I2C faults cost a wake, with the retry budgets and bus recovery of Sensor and WireBus.
+ *
+ * Runs the firmware on the simulated board with a fault injected on the bus and reports the wake length and the
+ * counters the firmware keeps in telemetry. Two cases:
+ *   wake     a whole measurement wake of MainController, the fault present from power on
+ *   read     one Sensor::readData() on a sensor that was set up fine, as on the main screen every 250 ms; the
+ *            fault appears before the first read and stays for the second
+ * "SDA held" is a device stuck mid-byte, freed after the given number of SCL clocks. Every row is bounded: the
+ * worst one is the longest a faulty bus can keep the unit awake.
+*/
+
+#include <cstdio>
+#include "Arduino.h"
+#include "HostBoard.h"
+#include "Controllers/MainController.h"
+#include "Sensor/Sensor.h"
+#include "Logger/Logger.h"
+#include "Telemetry/Telemetry.h"
+
+namespace {
+
+    constexpr uint8_t MEASUREMENT_INTERRUPT_PIN = 1; // MainController pins
+    constexpr uint64_t PULSE_US = 2000000;           // ATtiny412 FLASH_TIME
+
+    struct Fault {
+        const char *name;
+        bool sensorAcks;
+        uint8_t stuckClocks;
+    };
+
+    const Fault FAULTS[] = {
+        {"none", true, 0},
+        {"SDA held, 1 clock", true, 1},
+        {"SDA held, 9 clocks", true, 9},
+        {"SDA held for good", true, host::Board::STUCK_FOREVER},
+        {"BME280 not answering", false, 0},
+    };
+
+    int pulseInputs(uint8_t pin, uint64_t nowUs, void *) {
+      if (pin == MEASUREMENT_INTERRUPT_PIN) return nowUs < PULSE_US ? HIGH : LOW;
+      return pin == 0 ? LOW : -1; // button released, the rest follow their pull-ups
+    }
+
+    int noInputs(uint8_t, uint64_t, void *) { return -1; }
+
+    void inject(host::Board &board, const Fault &fault) {
+      board.sensorAcks = fault.sensorAcks;
+      board.i2cStuckClocks = fault.stuckClocks;
+    }
+
+    /** One measurement wake, from power on until the latch is released. Prints a row if `print` is set. */
+    void runWake(const Fault &fault, bool print) {
+      host::Board &board = host::Board::get();
+      Telemetry::Block before, after;
+      Telemetry::read(before);
+
+      board.powerOn(pulseInputs, nullptr);
+      inject(board, fault);
+      try {
+        MainController controller;
+        controller.setup();
+      } catch (host::PowerCut &) {
+      }
+      double ms = board.now() / 1000.0;
+      inject(board, FAULTS[0]);
+      if (!print) return;
+
+      Telemetry::read(after);
+      float logged[Logger::NUM_SAMPLES];
+      Logger().readTemperature(logged);
+      printf("%-24s%-7s%10.1f%12u%9u%8u%11.2f\n", fault.name, "wake", ms,
+             after.busRecoveries - before.busRecoveries, after.readyRetries - before.readyRetries,
+             after.sensorResets - before.sensorResets, logged[Logger::NUM_SAMPLES - 1]);
+    }
+
+    /** Two readData() calls on a sensor that was set up before the fault appeared. */
+    void runReads(const Fault &fault) {
+      host::Board &board = host::Board::get();
+      board.powerOn(noInputs, nullptr);
+      Sensor sensor;
+      sensor.setup();
+      inject(board, fault);
+      for (int read = 1; read <= 2; read++) {
+        uint64_t started = board.now();
+        Sensor::Data data = sensor.readData();
+        printf("%-24s%-7s%10.1f%12s%9s%8s%11.2f\n", fault.name, read == 1 ? "read 1" : "read 2",
+               (board.now() - started) / 1000.0, "", "", "", data.temperature);
+      }
+      inject(board, FAULTS[0]);
+    }
+
+}
+
+int main() {
+  host::Board &board = host::Board::get();
+  board.sensor.setEnvironment(21.0, 45.0);
+
+  printf("Bus attempts per register operation: %u, retry budget per wake: %u failed chip id reads and one reset\n",
+         Bus<WireBus>::ATTEMPTS, Sensor::RETRY_BUDGET);
+  printf("\n%-24s%-7s%10s%12s%9s%8s%11s\n", "fault", "case", "ms", "recoveries", "retries", "resets", "temp C");
+  // the first wake initialises the EEPROM, keep that out of the rows
+  runWake(FAULTS[0], false);
+  for (const Fault &fault : FAULTS) {
+    runWake(fault, true);
+    // telemetry is committed before the sensor is put to sleep, so what that costs lands in the next wake's counts
+    runWake(FAULTS[0], false);
+  }
+  for (const Fault &fault : FAULTS) runReads(fault);
+  return 0;
+}
@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+"""
+Check the Clock::idle() report of a Benchmark run (BenchmarkController::checkClock) on the part.
+
+Capture the run with host timestamps so the waits can be measured against the host clock as well:
+
+    pio run -e Benchmark -t upload && pio device monitor -e Benchmark --filter time > run.txt
+    clock_check.py run.txt
+
+Each wait is measured by the RTC (read by checkClock, around the call) and by TCB0, which counts CLK_PER at full
+speed outside the wait. It fails (status 1) if
+  - the RTC saw a wait shorter than requested, or longer by more than --overhead ms,
+  - millis() or TCB0 moved by anything but the RTC's measure of the wait (Clock::idle sets both from it), give or
+    take a millisecond,
+  - the button debounce did not end on the first loop idle past its interval, or millis() drifted from the RTC
+    over it,
+  - the ULP oscillator, which times every wait, was off from the main oscillator by more than --ulp-tolerance,
+  - a wait of a second or more was off by more than --tolerance on the host clock.
+Captures without timestamps skip the last check.
+"""
+
+import argparse
+import re
+import sys
+
+TIMESTAMP = re.compile(r"^(\d+):(\d+):(\d+(?:\.\d+)?) > ")  # pio device monitor --filter time
+LOOP_IDLE_TIME = 10  # MainController::LOOP_IDLE_TIME
+HOST_CHECKED_MS = 1000  # shorter waits drown in USB serial latency
+TICKS_PER_SECOND = 1024  # Clock::TICKS_PER_SECOND
+
+
+def parse(path):
+    """Return F_CPU and [(host seconds or None, fields)] for the last complete CLOCK_BEGIN..CLOCK_END block."""
+    lines, block = None, None
+    with open(path, errors="replace") as f:
+        for line in f:
+            line = line.strip()
+            stamp = None
+            match = TIMESTAMP.match(line)
+            if match:
+                stamp = int(match.group(1)) * 3600 + int(match.group(2)) * 60 + float(match.group(3))
+                line = line[match.end():]
+            fields = line.split(",")
+            if fields[0] == "CLOCK_BEGIN" and len(fields) == 2:
+                lines = [(stamp, fields)]
+            elif fields[0] == "CLOCK" and lines is not None:
+                lines.append((stamp, fields))
+            elif fields[0] == "CLOCK_END" and lines is not None:
+                block, lines = lines, None
+    if block is None:
+        sys.exit(f"{path}: no complete CLOCK_BEGIN,<F_CPU>..CLOCK_END block found")
+    return int(block[0][1][1]), block
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("capture")
+    parser.add_argument("--overhead", type=float, default=3.0, metavar="MS",
+                        help="allowed time of a wait past the request on the RTC (default 3 ms)")
+    parser.add_argument("--ulp-tolerance", type=float, default=3.0, metavar="PCT",
+                        help="allowed error of the ULP oscillator against the main one (default 3%%)")
+    parser.add_argument("--tolerance", type=float, default=1.0, metavar="PCT",
+                        help="allowed error of a wait on the host clock against the RTC's measure (default 1%%)")
+    args = parser.parse_args()
+
+    f_cpu, block = parse(args.capture)
+    failures = []
+    seen = set()
+    ulp = 0.0
+    print(f"{'check':<10}{'requested':>10}{'millis':>8}{'RTC ms':>9}{'TCB0 ms':>9}{'host ms':>9}")
+    for (before, _), (after, fields) in zip(block, block[1:]):
+        seen.add((fields[1], len(fields)))
+        if fields[1] == "ulp" and len(fields) == 4:
+            rtc, tcb = int(fields[2]) * 1000 / TICKS_PER_SECOND, int(fields[3]) * 1000 / f_cpu
+            ulp = 100 * (rtc / tcb - 1)
+            print(f"{'ulp':<10}{'':>10}{'':>8}{rtc:>9.1f}{tcb:>9.1f}{'':>9}  ULP {ulp:+.2f}% against F_CPU")
+            if abs(ulp) > args.ulp_tolerance:
+                failures.append(f"the ULP oscillator runs {ulp:+.2f}% off the main one")
+        elif fields[1] == "idle" and len(fields) == 6:
+            requested, elapsed = int(fields[2]), int(fields[3])
+            rtc, tcb = int(fields[4]) * 1000 / TICKS_PER_SECOND, int(fields[5]) * 1000 / f_cpu
+            host = (after - before) * 1000 if before is not None and after is not None else None
+            print(f"{'idle':<10}{requested:>10}{elapsed:>8}{rtc:>9.1f}{tcb:>9.1f}"
+                  f"{'-' if host is None else f'{host:.0f}':>9}")
+            if rtc < requested:
+                failures.append(f"idle({requested}) took {rtc:.1f} ms on the RTC")
+            if rtc > requested + args.overhead:
+                failures.append(f"idle({requested}) overran to {rtc:.1f} ms on the RTC")
+            if abs(elapsed - rtc) > 1:
+                failures.append(f"idle({requested}) moved millis() by {elapsed}, the RTC by {rtc:.1f} ms")
+            if abs(tcb - rtc) > 1:
+                failures.append(f"idle({requested}) moved TCB0 by {tcb:.1f} ms, the RTC by {rtc:.1f} ms")
+            if host is not None and requested >= HOST_CHECKED_MS:
+                expected = rtc / (1 + ulp / 100)  # the RTC's measure in main oscillator time
+                if abs(host - expected) > expected * args.tolerance / 100:
+                    failures.append(f"idle({requested}) took {host:.0f} ms on the host clock, {expected:.0f} expected")
+        elif fields[1] == "debounce" and len(fields) == 6:
+            interval, idles, elapsed = int(fields[2]), int(fields[3]), int(fields[4])
+            rtc = int(fields[5]) * 1000 / TICKS_PER_SECOND
+            print(f"{'debounce':<10}{interval:>10}{elapsed:>8}{rtc:>9.1f}{'':>9}{'':>9}  {idles} idles")
+            if not interval < elapsed <= interval + LOOP_IDLE_TIME + args.overhead:
+                failures.append(f"debounce of {interval} ms ended after {elapsed} ms of millis()")
+            if abs(elapsed - rtc) > 2:
+                failures.append(f"debounce moved millis() by {elapsed}, the RTC by {rtc:.1f} ms")
+
+    for check, length in (("ulp", 4), ("idle", 6), ("debounce", 6)):
+        if (check, length) not in seen:
+            failures.append(f"no {check} line with {length - 1} fields")
+
+    if failures:
+        print("clock check failed: " + "; ".join(failures), file=sys.stderr)
+        return 1
+    print("clock check passed")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,310 @@
+/*
+ * display_check: what Display puts in the simulated SSD1306 RAM, against other ways of drawing the same frame.
+ *
+ * Main screen: drives one Display through random sequences of frames (small steps that change one or two
+ * characters, jumps across the readout formats, the stale marker switching on and off, and charts in between), so
+ * every frame after the first of a sequence goes through changedTiles and drawMainTiles. After each frame the panel
+ * RAM is saved and the same frame is drawn again by a fresh Display, which has nothing shown and so redraws the
+ * whole panel in the page loop. Both are compared byte for byte with each other and with a reference drawing.
+ *
+ * Charts: random histories of every channel, compared with a reference drawing.
+ *
+ * The reference is the glyph path from before the generated font tables: the old font array and charIndex chain,
+ * and one scale x scale box per lit pixel. So it checks charTable, glyphXbm, spread2 and spread4 against what they
+ * replaced. The character lookup and glyph columns are also compared directly for all 256 characters.
+ * Exits non-zero on any difference.
+*/
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include "Arduino.h"
+#include "HostBoard.h"
+#include "Display/Display.h"
+#include "Logger/Logger.h"
+
+namespace {
+
+    struct Options {
+        int frames = 50000;
+        int charts = 5000;
+        uint64_t seed = 1;
+    };
+
+    /** The font array the glyph path drew from before FontTables.h, rows bit 0 at the top. */
+    const uint8_t OLD_FONT[][6] = {
+            {0x3E, 0x51, 0x49, 0x45, 0x3E, 0x00},  // 0
+            {0x00, 0x42, 0x7F, 0x40, 0x00, 0x00},  // 1
+            {0x42, 0x61, 0x51, 0x49, 0x46, 0x00},  // 2
+            {0x21, 0x41, 0x45, 0x4B, 0x31, 0x00},  // 3
+            {0x18, 0x14, 0x12, 0x7F, 0x10, 0x00},  // 4
+            {0x27, 0x45, 0x45, 0x45, 0x39, 0x00},  // 5
+            {0x3C, 0x4A, 0x49, 0x49, 0x30, 0x00},  // 6
+            {0x01, 0x71, 0x09, 0x05, 0x03, 0x00},  // 7
+            {0x36, 0x49, 0x49, 0x49, 0x36, 0x00},  // 8
+            {0x06, 0x49, 0x49, 0x29, 0x1E, 0x00},  // 9
+            {0x00, 0x00, 0x60, 0x60, 0x00, 0x00},  // .
+            {0x06, 0x09, 0x09, 0x06, 0x00, 0x00},  // d (degree)
+            {0x62, 0x64, 0x08, 0x13, 0x23, 0x00},  // %
+            {0x08, 0x08, 0x08, 0x08, 0x08, 0x00},  // -
+            {0x01, 0x01, 0x7F, 0x01, 0x01, 0x00},  // T
+            {0x7F, 0x08, 0x08, 0x08, 0x7F, 0x00},  // H
+            {0x7F, 0x49, 0x49, 0x49, 0x41, 0x00},  // E
+            {0x7F, 0x02, 0x04, 0x02, 0x7F, 0x00},  // M
+            {0x7F, 0x09, 0x09, 0x09, 0x06, 0x00},  // P
+            {0x3F, 0x40, 0x40, 0x40, 0x3F, 0x00},  // U
+            {0x00, 0x41, 0x7F, 0x41, 0x00, 0x00},  // I
+            {0x7F, 0x41, 0x41, 0x22, 0x1C, 0x00},  // D
+    };
+
+    /** The old character lookup. */
+    uint8_t oldCharIndex(char c) {
+      if (c >= '0' && c <= '9') return c - '0';
+      if (c == '.') return 10;
+      if (c == 'd') return 11;
+      if (c == '%') return 12;
+      if (c == '-') return 13;
+      if (c == 'T') return 14;
+      if (c == 'H') return 15;
+      if (c == 'E') return 16;
+      if (c == 'M') return 17;
+      if (c == 'P') return 18;
+      if (c == 'U') return 19;
+      if (c == 'I') return 20;
+      if (c == 'D') return 21;
+      return 0xFF;
+    }
+
+    /** Display's formatting and lookups, which the reference shares or checks. */
+    class Tables : public DisplayBase {
+    public:
+        using DisplayBase::charIndex;
+        using DisplayBase::glyphColumn;
+        using DisplayBase::formattedTempString;
+        using DisplayBase::formattedHumString;
+        using DisplayBase::formatAxisLabels;
+    };
+
+    /** Display RAM drawn the old way: u8g2 boxes and lines, and text one scale x scale box per lit pixel. */
+    struct Reference {
+        uint8_t ram[8][128];
+
+        void clear() { memset(ram, 0, sizeof(ram)); }
+
+        void box(int x, int y, int w, int h) {
+          for (int row = y < 0 ? 0 : y; row < y + h && row < 64; row++) {
+            for (int col = x < 0 ? 0 : x; col < x + w && col < 128; col++) ram[row / 8][col] |= 1 << row % 8;
+          }
+        }
+
+        void line(int x0, int y0, int x1, int y1) { // horizontal or vertical, both ends drawn
+          box(x0 < x1 ? x0 : x1, y0 < y1 ? y0 : y1, abs(x1 - x0) + 1, abs(y1 - y0) + 1);
+        }
+
+        void drawCharScale(int x0, int y0, char c, int scale) {
+          uint8_t idx = oldCharIndex(c);
+          if (idx == 0xFF) return;
+          for (int col = 0; col < 6; col++) {
+            for (int row = 0; row < 8; row++) {
+              if (OLD_FONT[idx][col] & (1 << row)) box(x0 + col * scale, y0 + row * scale, scale, scale);
+            }
+          }
+        }
+
+        void drawStringScale(int x, int y, const char *s, int scale) {
+          for (; *s; s++, x += 6 * scale) drawCharScale(x, y, *s, scale);
+        }
+
+        void main(const char *temperature, const char *humidity, bool stale) {
+          clear();
+          drawCharScale(0, 0, 'T', 2);
+          drawStringScale(12, 0, temperature, 4);
+          drawCharScale(0, 36, 'H', 2);
+          drawStringScale(12, 36, humidity, 4);
+          for (int dash = 0; stale && dash < 3; dash++) {
+            box(dash * 4, 16, 2, 1);
+            box(dash * 4, 52, 2, 1);
+          }
+        }
+
+        /** The chart of cells (oldest first), with the integer bar scaling of displayChart. */
+        void chart(const uint8_t *cells, LoggerCodec::Channel channel, Tables &tables) {
+          clear();
+          uint16_t maxVal = 0, minVal = UINT16_MAX;
+          for (uint8_t i = 0; i < LoggerCodec::NUM_SAMPLES; i++) {
+            uint16_t value = LoggerCodec::scaled(channel, cells[i]);
+            if (value > maxVal) maxVal = value;
+            if (value < minVal) minVal = value;
+          }
+          constexpr uint16_t PAD = 2 * LoggerCodec::UNIT;
+          uint16_t range = maxVal - minVal + 2 * PAD;
+          for (uint8_t i = 0; i < LoggerCodec::NUM_SAMPLES; i++) {
+            int barHeight = (uint32_t) (LoggerCodec::scaled(channel, cells[i]) - minVal + PAD) * 53 / range;
+            box(16 + (LoggerCodec::NUM_SAMPLES - 1 - i) * 4, 64 - barHeight, 3, barHeight);
+          }
+
+          const char *title = LoggerCodec::isTemperature(channel) ? "TEMP" : "HUMID";
+          drawStringScale(72 - (int) strlen(title) * 6 / 2, 0, title, 1);
+          int32_t offset = (int32_t) LoggerCodec::channelMin(channel) * LoggerCodec::UNIT;
+          drawStringScale(0, 12, tables.formatAxisLabels(
+                  (2 * (offset + maxVal + PAD) + LoggerCodec::UNIT) / (2 * LoggerCodec::UNIT)), 1);
+          drawStringScale(0, 56, tables.formatAxisLabels(
+                  (2 * (offset + minVal - PAD) + LoggerCodec::UNIT) / (2 * LoggerCodec::UNIT)), 1);
+          line(16, 64, 16, 0);
+          line(0, 64, 128, 64);
+          line(16, 10, 128, 10);
+          drawStringScale(128 - 16 + 2, 1, "7D", 1);
+        }
+    };
+
+    /** Report the first byte where the panel differs from what was expected, the first few times. */
+    bool differs(const uint8_t (&panel)[8][128], const uint8_t (&expected)[8][128], const char *against, int &count,
+                 const char *frame) {
+      if (memcmp(panel, expected, sizeof(expected)) == 0) return false;
+      if (count++ < 10) {
+        int at = 0;
+        while (panel[at / 128][at % 128] == expected[at / 128][at % 128]) at++;
+        printf("%s: page %d column %d is 0x%02X, %s gives 0x%02X\n", frame, at / 128, at % 128,
+               panel[at / 128][at % 128], against, expected[at / 128][at % 128]);
+      }
+      return true;
+    }
+
+    int noInputs(uint8_t, uint64_t, void *) { return -1; }
+
+    /** The next reading: mostly a step of a few hundredths, sometimes a jump anywhere in the readout formats. */
+    float nextValue(std::mt19937_64 &rng, float value, float low, float high) {
+      std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+      if (unit(rng) < 0.2f) return low + (high - low) * unit(rng);
+      return value + (unit(rng) - 0.5f) * 0.2f;
+    }
+
+    /** Fill the history with random samples, so the chart frames in between vary. */
+    void fillHistory(Logger &history, std::mt19937_64 &rng) {
+      std::uniform_real_distribution<float> temperature(-60.0f, 70.0f);
+      std::uniform_real_distribution<float> humidity(-5.0f, 105.0f);
+      float base = temperature(rng);
+      for (uint8_t i = 0; i < Logger::NUM_SAMPLES; i++) {
+        float t = rng() % 4 ? base + temperature(rng) * 0.05f : temperature(rng);
+        history.push(t, humidity(rng), 0, temperature(rng), humidity(rng));
+      }
+    }
+
+    void usage(const char *argv0) {
+      fprintf(stderr,
+              "usage: %s [options]\n"
+              "  --frames N        main screen frames to compare (50000)\n"
+              "  --charts N        charts to compare (5000)\n"
+              "  --seed S          random seed (1)\n", argv0);
+      exit(2);
+    }
+
+}
+
+int main(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (i + 1 >= argc) usage(argv[0]);
+    const char *value = argv[++i];
+    if (arg == "--frames") options.frames = atoi(value);
+    else if (arg == "--charts") options.charts = atoi(value);
+    else if (arg == "--seed") options.seed = strtoull(value, nullptr, 10);
+    else usage(argv[0]);
+  }
+  if (options.frames < 1 || options.charts < 0) usage(argv[0]);
+
+  host::Board &board = host::Board::get();
+  board.powerOn(noInputs, nullptr);
+  std::mt19937_64 rng(options.seed);
+  Tables tables;
+  Reference reference;
+  int lookupErrors = 0;
+  for (int c = 0; c < 256; c++) {
+    uint8_t glyph = oldCharIndex((char) c);
+    if (tables.charIndex((char) c) != glyph) {
+      if (lookupErrors++ < 10) printf("character 0x%02X: glyph %u, the old lookup gives %u\n", c,
+                                      tables.charIndex((char) c), glyph);
+      continue;
+    }
+    for (uint8_t col = 0; glyph != 0xFF && col < Font::WIDTH; col++) {
+      if (tables.glyphColumn(glyph, col) != OLD_FONT[glyph][col] && lookupErrors++ < 10) {
+        printf("glyph %u column %u: 0x%02X, the old font has 0x%02X\n", glyph, col, tables.glyphColumn(glyph, col),
+               OLD_FONT[glyph][col]);
+      }
+    }
+  }
+
+  Logger history;
+  history.begin();
+  Display display;
+  display.setup();
+
+  float temperature = 21.5f, humidity = 45.0f;
+  bool stale = false;
+  int fastFrames = 0, tileErrors = 0, mainErrors = 0;
+  unsigned tiles = 0;
+  bool shown = false; // display has the main screen up, so the next frame takes the fast path
+  uint8_t fast[8][128];
+  char frame[64];
+  for (int i = 0; i < options.frames; i++) {
+    if (rng() % 64 == 0) {
+      // something else on the panel in between: a chart, or the panel switched off and back on
+      if (rng() % 2) {
+        fillHistory(history, rng);
+        display.displayChart(history, (LoggerCodec::Channel) (rng() % 4));
+      } else {
+        display.powerDown();
+        display.setup();
+      }
+      shown = false;
+    }
+
+    temperature = nextValue(rng, temperature, -120.0f, 130.0f);
+    humidity = nextValue(rng, humidity, -5.0f, 105.0f);
+    if (rng() % 8 == 0) stale = !stale;
+    snprintf(frame, sizeof(frame), "frame %d (%.3f, %.3f%s)", i, temperature, humidity, stale ? ", stale" : "");
+
+    unsigned tilesBefore = board.tilesSent;
+    display.displayMain(temperature, humidity, stale);
+    if (shown) {
+      fastFrames++;
+      tiles += board.tilesSent - tilesBefore;
+    }
+    shown = true;
+    memcpy(fast, board.panel, sizeof(fast));
+
+    Display fresh;
+    fresh.setup();
+    fresh.displayMain(temperature, humidity, stale);
+    differs(fast, board.panel, "a full redraw", tileErrors, frame);
+
+    char temperatureText[8];
+    strcpy(temperatureText, tables.formattedTempString(temperature));
+    reference.main(temperatureText, tables.formattedHumString(humidity), stale);
+    differs(board.panel, reference.ram, "the old glyph path", mainErrors, frame);
+  }
+
+  int chartErrors = 0;
+  for (int i = 0; i < options.charts; i++) {
+    fillHistory(history, rng);
+    LoggerCodec::Channel channel = (LoggerCodec::Channel) (i % 4);
+    display.displayChart(history, channel);
+
+    uint8_t cells[LoggerCodec::NUM_SAMPLES];
+    history.visit(channel, [&](uint8_t index, uint8_t encoded) { cells[index] = encoded; });
+    reference.chart(cells, channel, tables);
+    snprintf(frame, sizeof(frame), "chart %d (channel %d)", i, channel);
+    differs(board.panel, reference.ram, "the old glyph path", chartErrors, frame);
+  }
+
+  printf("character lookup and glyph columns: %d differ from the old font\n", lookupErrors);
+  printf("%d main screen frames, %d through the tile path (%.1f tiles each)\n", options.frames, fastFrames,
+         fastFrames ? (double) tiles / fastFrames : 0.0);
+  printf("  %d differ from a full redraw, %d from the old glyph path\n", tileErrors, mainErrors);
+  printf("%d charts, %d differ from the old glyph path\n", options.charts, chartErrors);
+  return lookupErrors || tileErrors || mainErrors || chartErrors ? 1 : 0;
+}
@@ -0,0 +1,189 @@
+/*
+ * Host side of the UART export protocol.
+*/
+
+#include "ExportReceiver.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace download {
+
+    namespace {
+
+        uint16_t crc(const uint8_t *data, size_t length) {
+          uint16_t value = 0;
+          for (size_t i = 0; i < length; i++) value = ExportProtocol::crcUpdate(value, data[i]);
+          return value;
+        }
+
+        uint16_t le16(const uint8_t *data) {
+          return (uint16_t) (data[0] | data[1] << 8);
+        }
+
+    }
+
+    bool Receiver::receive(std::vector<uint8_t> &image, size_t &received, int firstByteMs, int silenceMs,
+                           int retries) {
+      if (received > image.size()) received = 0;
+      pending.clear();
+      lastError.clear();
+      bool heard = false;
+      int silences = 0;
+      long requested = -1; // offset of the last RESUME, so a burst of stale frames only triggers one
+
+      auto resume = [&]() {
+        if (requested == (long) received) return;
+        sendCommand(ExportProtocol::RESUME, (uint16_t) received);
+        requested = (long) received;
+      };
+
+      while (true) {
+        // parse every complete frame in the buffer
+        size_t start = 0;
+        while (true) {
+          while (start < pending.size() && pending[start] != ExportProtocol::SYNC) start++;
+          if (pending.size() - start < ExportProtocol::HEADER_SIZE) break;
+          const uint8_t *frame = pending.data() + start;
+          uint8_t length = frame[4];
+          if (length > ExportProtocol::MAX_PAYLOAD) {
+            totals.badFrames++;
+            start++; // not a real frame start
+            resume();
+            continue;
+          }
+          size_t frameSize = ExportProtocol::HEADER_SIZE + length + ExportProtocol::CRC_SIZE;
+          if (pending.size() - start < frameSize) break;
+          if (crc(frame + 1, ExportProtocol::HEADER_SIZE - 1 + length) !=
+              le16(frame + ExportProtocol::HEADER_SIZE + length)) {
+            totals.badFrames++;
+            start++;
+            resume();
+            continue;
+          }
+
+          totals.frames++;
+          silences = 0;
+          uint8_t type = frame[1];
+          uint16_t offset = le16(frame + 2);
+          const uint8_t *payload = frame + ExportProtocol::HEADER_SIZE;
+          start += frameSize;
+
+          if (type == ExportProtocol::HELLO && length >= 3) {
+            if (payload[0] != ExportProtocol::VERSION || le16(payload + 1) != image.size()) {
+              lastError = "device speaks protocol version " + std::to_string(payload[0]) + " with a " +
+                          std::to_string(le16(payload + 1)) + " byte image, expected version " +
+                          std::to_string(ExportProtocol::VERSION) + " with " + std::to_string(image.size());
+              return false;
+            }
+            requested = -1;
+            if (received) resume(); // skip what an earlier attempt already got
+          } else if (type == ExportProtocol::DATA) {
+            if (offset == received && received + length <= image.size()) {
+              std::copy(payload, payload + length, image.begin() + received);
+              received += length;
+              totals.payloadBytes += length;
+              if (progress) progress(image, received);
+            } else if (offset > received) {
+              resume(); // lost something in between
+            } // else a repeat of what we already have
+          } else if (type == ExportProtocol::END && length >= 2) {
+            if (received == image.size()) {
+              if (crc(image.data(), image.size()) != le16(payload)) {
+                lastError = "image CRC mismatch";
+                return false;
+              }
+              sendCommand(ExportProtocol::DONE, 0);
+              pending.erase(pending.begin(), pending.begin() + start);
+              return true;
+            }
+            requested = -1; // the device finished without us, ask again even if we already did
+            resume();
+          }
+        }
+        pending.erase(pending.begin(), pending.begin() + start);
+
+        if (!fill(heard ? silenceMs : firstByteMs)) {
+          if (!lastError.empty()) return false;
+          if (!heard) {
+            lastError = "no response from the device";
+            return false;
+          }
+          totals.timeouts++;
+          if (++silences > retries) {
+            lastError = "link went quiet at offset " + std::to_string(received);
+            return false;
+          }
+          requested = -1;
+          resume();
+          continue;
+        }
+        heard = true;
+      }
+    }
+
+    /**
+     * Read whatever arrives within timeoutMs into `pending`. Returns false on silence or a read error.
+     */
+    bool Receiver::fill(int timeoutMs) {
+      pollfd pfd = {fd, POLLIN, 0};
+      int ready = poll(&pfd, 1, timeoutMs);
+      if (ready < 0 && errno == EINTR) return true;
+      if (ready <= 0) return false;
+
+      uint8_t chunk[512];
+      ssize_t n = read(fd, chunk, sizeof(chunk));
+      if (n <= 0) {
+        if (n < 0 && (errno == EINTR || errno == EAGAIN)) return true;
+        lastError = "link closed";
+        return false;
+      }
+      if (tap) tap(chunk, (size_t) n);
+      totals.wireBytes += n;
+      pending.insert(pending.end(), chunk, chunk + n);
+      return true;
+    }
+
+    void Receiver::sendCommand(uint8_t type, uint16_t offset) {
+      uint8_t frame[ExportProtocol::COMMAND_FRAME] = {ExportProtocol::SYNC, type, (uint8_t) (offset & 0xFF),
+                                                      (uint8_t) (offset >> 8), 0};
+      uint16_t value = crc(frame + 1, ExportProtocol::HEADER_SIZE - 1);
+      frame[ExportProtocol::HEADER_SIZE] = value & 0xFF;
+      frame[ExportProtocol::HEADER_SIZE + 1] = value >> 8;
+      if (type == ExportProtocol::RESUME) totals.resumes++;
+
+      size_t sent = 0;
+      while (sent < sizeof(frame)) {
+        ssize_t n = write(fd, frame + sent, sizeof(frame) - sent);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return; // reported as silence or a closed link by the next read
+        sent += n;
+      }
+    }
+
+    int openPort(const char *path) {
+      int fd = open(path, O_RDWR | O_NOCTTY);
+      if (fd < 0) return -1;
+
+      termios tio;
+      if (tcgetattr(fd, &tio) < 0) {
+        close(fd);
+        return -1;
+      }
+      cfmakeraw(&tio);
+      tio.c_cflag |= CLOCAL | CREAD;
+      tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+      tio.c_cc[VMIN] = 0;
+      tio.c_cc[VTIME] = 0;
+      static_assert(ExportProtocol::BAUD == 500000, "update the termios speed below");
+      if (cfsetspeed(&tio, B500000) < 0 || tcsetattr(fd, TCSANOW, &tio) < 0) {
+        close(fd);
+        return -1;
+      }
+      tcflush(fd, TCIOFLUSH);
+      return fd;
+    }
+
+}
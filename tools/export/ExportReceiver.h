@@ -0,0 +1,80 @@
+/*
+ * Host side of the UART export protocol (src/Export/ExportProtocol.h).
+*/
+
+#ifndef TEMPERATURETRACKER_EXPORTRECEIVER_H
+#define TEMPERATURETRACKER_EXPORTRECEIVER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+#include <string>
+#include <vector>
+#include "Export/ExportProtocol.h"
+
+namespace download {
+
+    /** Totals over everything received so far. */
+    struct Stats {
+        uint64_t wireBytes = 0;    // bytes read from the link, including framing and junk
+        uint64_t frames = 0;       // frames with a valid CRC
+        uint64_t payloadBytes = 0; // new image bytes accepted
+        uint64_t badFrames = 0;    // CRC or length errors
+        uint64_t resumes = 0;      // RESUME commands sent
+        uint64_t timeouts = 0;     // times the link went quiet mid transfer
+    };
+
+    /**
+     * Reassembles the export image from the frames a device sends, asking it to resume from the first missing
+     * offset after a corrupted frame, a gap or silence.
+     */
+    class Receiver {
+    public:
+        /** Called with every chunk read from the link before it is parsed, e.g. to inject noise. */
+        typedef std::function<void(uint8_t *data, size_t length)> Tap;
+
+        /** Called after new image bytes have been accepted, e.g. to save progress for a later resume. */
+        typedef std::function<void(const std::vector<uint8_t> &image, size_t received)> Progress;
+
+        /** `fd` must already be set up as a raw link at ExportProtocol::BAUD. */
+        explicit Receiver(int fd) : fd(fd) {}
+
+        void setTap(Tap value) { tap = std::move(value); }
+
+        void setProgress(Progress value) { progress = std::move(value); }
+
+        /**
+         * Receive one export. The first `received` bytes of `image` are taken as already valid and are not
+         * requested again.
+         *
+         * @param firstByteMs How long to wait for the device to start talking.
+         * @param silenceMs How long the link may go quiet before asking the device to resume.
+         * @param retries Consecutive silences tolerated before giving up.
+         * @return True once the image is complete and matches the CRC the device sent with END.
+         */
+        bool receive(std::vector<uint8_t> &image, size_t &received, int firstByteMs, int silenceMs, int retries);
+
+        const Stats &stats() const { return totals; }
+
+        /** Why the last receive() failed. */
+        const std::string &error() const { return lastError; }
+
+    private:
+        int fd;
+        Tap tap;
+        Progress progress;
+        Stats totals;
+        std::string lastError;
+        std::vector<uint8_t> pending; // read but not yet parsed
+
+        bool fill(int timeoutMs);
+
+        void sendCommand(uint8_t type, uint16_t offset);
+    };
+
+    /** Open a serial port as a raw 8N1 link at ExportProtocol::BAUD. Returns -1 and sets errno on failure. */
+    int openPort(const char *path);
+
+}
+
+#endif //TEMPERATURETRACKER_EXPORTRECEIVER_H
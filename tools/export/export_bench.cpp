@@ -0,0 +1,152 @@
+/*
+ * export_bench: throughput of the UART export over a pseudo terminal.
+ *
+ * A child process runs the firmware's Exporter on the simulated board with its UART attached to one end of a pty,
+ * the parent runs the host Receiver on the other end. The pty has no baud rate, so the wall clock figures show the
+ * protocol and host overhead, while the projected time is what the same traffic takes on a 500 kBd wire.
+ * --noise flips random bits on the way in to exercise the resume path.
+*/
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <unistd.h>
+#include "Arduino.h"
+#include "HostBoard.h"
+#include "Export/Exporter.h"
+#include "ExportReceiver.h"
+
+namespace {
+
+    struct Options {
+        int transfers = 200;
+        double noise = 0.0; // probability of a bit error per received byte
+        unsigned seed = 1;
+    };
+
+    void usage(const char *argv0) {
+      fprintf(stderr,
+              "usage: %s [--transfers N] [--noise P] [--seed S]\n"
+              "  --transfers N  exports to run back to back (200)\n"
+              "  --noise P      probability of a flipped bit per received byte (0)\n"
+              "  --seed S       seed for the EEPROM contents and the noise (1)\n", argv0);
+      exit(2);
+    }
+
+    int buttonReleased(uint8_t, uint64_t, void *) { return LOW; }
+
+    /** Device side: serve `transfers` exports, then exit. */
+    void runDevice(int fd, int transfers) {
+      host::Board &board = host::Board::get();
+      board.serialFd = fd;
+      board.wallClockDelays = true; // so the exporter's idle timeout is real time for the receiver
+
+      Sensor sensor;
+      sensor.setup();
+      for (int i = 0; i < transfers; i++) Exporter(sensor).run();
+      _exit(0);
+    }
+
+}
+
+int main(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--transfers" && i + 1 < argc) options.transfers = atoi(argv[++i]);
+    else if (arg == "--noise" && i + 1 < argc) options.noise = atof(argv[++i]);
+    else if (arg == "--seed" && i + 1 < argc) options.seed = (unsigned) atoi(argv[++i]);
+    else usage(argv[0]);
+  }
+  if (options.transfers <= 0) usage(argv[0]);
+
+  // the image the device will send: random EEPROM plus the calibration of the simulated sensor
+  std::mt19937 rng(options.seed);
+  host::Board &board = host::Board::get();
+  board.powerOn(buttonReleased, nullptr);
+  for (uint8_t &cell : board.eeprom) cell = (uint8_t) rng();
+  std::vector<uint8_t> expected(ExportProtocol::IMAGE_SIZE);
+  {
+    Sensor sensor;
+    sensor.setup();
+    for (uint16_t i = 0; i < ExportProtocol::IMAGE_SIZE; i++) {
+      expected[i] = i < ExportProtocol::CALIBRATION_OFFSET ? board.eeprom[i]
+                                                           : sensor.readCalibrationRegister(
+                      i - ExportProtocol::CALIBRATION_OFFSET);
+    }
+  }
+
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || grantpt(master) < 0 || unlockpt(master) < 0) {
+    perror("pty");
+    return 1;
+  }
+  int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+  termios tio;
+  if (slave < 0 || tcgetattr(slave, &tio) < 0) {
+    perror("pty");
+    return 1;
+  }
+  cfmakeraw(&tio);
+  tcsetattr(slave, TCSANOW, &tio);
+  signal(SIGPIPE, SIG_IGN);
+
+  pid_t child = fork();
+  if (child < 0) {
+    perror("fork");
+    return 1;
+  }
+  if (child == 0) {
+    close(master);
+    runDevice(slave, options.transfers);
+  }
+  close(slave);
+
+  download::Receiver receiver(master);
+  std::bernoulli_distribution flip(options.noise);
+  if (options.noise > 0) {
+    receiver.setTap([&](uint8_t *data, size_t length) {
+      for (size_t i = 0; i < length; i++) {
+        if (flip(rng)) data[i] ^= (uint8_t) (1 << (rng() % 8));
+      }
+    });
+  }
+
+  int completed = 0;
+  int mismatched = 0;
+  auto started = std::chrono::steady_clock::now();
+  for (int i = 0; i < options.transfers; i++) {
+    std::vector<uint8_t> image(ExportProtocol::IMAGE_SIZE);
+    size_t received = 0;
+    if (!receiver.receive(image, received, 10000, 100, 50)) {
+      fprintf(stderr, "transfer %d failed: %s\n", i, receiver.error().c_str());
+      break;
+    }
+    completed++;
+    if (image != expected) mismatched++;
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+  close(master);
+  kill(child, SIGTERM);
+  waitpid(child, nullptr, 0);
+
+  const download::Stats &stats = receiver.stats();
+  double wirePerTransfer = completed ? (double) stats.wireBytes / completed : 0;
+  printf("%d/%d transfers of %u bytes in %.3f s over the pty (%.0f transfers/s, %.1f kB/s of image)\n",
+         completed, options.transfers, ExportProtocol::IMAGE_SIZE, seconds, completed / seconds,
+         completed * (double) ExportProtocol::IMAGE_SIZE / seconds / 1000);
+  printf("wire bytes per transfer %.1f, efficiency %.1f%%, projected %.2f ms per transfer at %lu Bd\n",
+         wirePerTransfer, wirePerTransfer ? 100.0 * ExportProtocol::IMAGE_SIZE / wirePerTransfer : 0.0,
+         wirePerTransfer * 10 * 1000 / ExportProtocol::BAUD, (unsigned long) ExportProtocol::BAUD);
+  printf("frames %llu, bad %llu, resumes %llu, timeouts %llu, wrong images %d\n",
+         (unsigned long long) stats.frames, (unsigned long long) stats.badFrames,
+         (unsigned long long) stats.resumes, (unsigned long long) stats.timeouts, mismatched);
+  return completed == options.transfers && !mismatched ? 0 : 1;
+}
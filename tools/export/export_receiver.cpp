@@ -0,0 +1,109 @@
+/*
+ * export_receiver: download the export image from a unit in export mode.
+ *
+ * Start the receiver, then hold the unit's button through power on until the transfer starts:
+ *
+ *   export_receiver --port /dev/ttyUSB0 --out unit1
+ *
+ * writes unit1.eeprom.bin (the raw 256-byte EEPROM, for eeprom_ingest, telemetry_decode.py and trace_decode.py)
+ * and unit1.cal.bin (the raw BME280 calibration registers). Progress is kept in unit1.part, so an interrupted
+ * transfer can be continued with --resume instead of starting over.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include "ExportReceiver.h"
+
+namespace {
+
+    void usage(const char *argv0) {
+      fprintf(stderr,
+              "usage: %s --port DEVICE --out PREFIX [--resume] [--wait S] [--silence MS] [--retries N]\n"
+              "  --port DEVICE  serial port the unit's UART is connected to\n"
+              "  --out PREFIX   write PREFIX.eeprom.bin and PREFIX.cal.bin\n"
+              "  --resume       continue from PREFIX.part instead of starting over\n"
+              "  --wait S       seconds to wait for the unit to start talking (30)\n"
+              "  --silence MS   quiet time before asking the unit to resume (200)\n"
+              "  --retries N    quiet periods in a row before giving up (20)\n", argv0);
+      exit(2);
+    }
+
+    bool writeFile(const std::string &path, const uint8_t *data, size_t length) {
+      FILE *f = fopen(path.c_str(), "wb");
+      if (!f) {
+        perror(path.c_str());
+        return false;
+      }
+      bool ok = fwrite(data, 1, length, f) == length;
+      ok = fclose(f) == 0 && ok;
+      if (!ok) perror(path.c_str());
+      return ok;
+    }
+
+}
+
+int main(int argc, char **argv) {
+  const char *port = nullptr;
+  std::string prefix;
+  bool resume = false;
+  int waitS = 30;
+  int silenceMs = 200;
+  int retries = 20;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--port" && i + 1 < argc) port = argv[++i];
+    else if (arg == "--out" && i + 1 < argc) prefix = argv[++i];
+    else if (arg == "--resume") resume = true;
+    else if (arg == "--wait" && i + 1 < argc) waitS = atoi(argv[++i]);
+    else if (arg == "--silence" && i + 1 < argc) silenceMs = atoi(argv[++i]);
+    else if (arg == "--retries" && i + 1 < argc) retries = atoi(argv[++i]);
+    else usage(argv[0]);
+  }
+  if (!port || prefix.empty()) usage(argv[0]);
+
+  std::vector<uint8_t> image(ExportProtocol::IMAGE_SIZE);
+  size_t received = 0;
+  std::string partPath = prefix + ".part";
+  if (resume) {
+    if (FILE *f = fopen(partPath.c_str(), "rb")) {
+      received = fread(image.data(), 1, image.size(), f);
+      fclose(f);
+      fprintf(stderr, "resuming at offset %zu\n", received);
+    }
+  }
+
+  int fd = download::openPort(port);
+  if (fd < 0) {
+    perror(port);
+    return 1;
+  }
+
+  download::Receiver receiver(fd);
+  receiver.setProgress([&](const std::vector<uint8_t> &data, size_t count) {
+    writeFile(partPath, data.data(), count);
+  });
+  fprintf(stderr, "waiting for the unit, hold its button through power on\n");
+  bool ok = receiver.receive(image, received, waitS * 1000, silenceMs, retries);
+  close(fd);
+
+  const download::Stats &stats = receiver.stats();
+  fprintf(stderr, "%zu/%u bytes, %llu frames, %llu bad, %llu resumes, %llu timeouts\n", received,
+          ExportProtocol::IMAGE_SIZE, (unsigned long long) stats.frames, (unsigned long long) stats.badFrames,
+          (unsigned long long) stats.resumes, (unsigned long long) stats.timeouts);
+  if (!ok) {
+    fprintf(stderr, "%s: %s%s\n", port, receiver.error().c_str(), received ? ", continue with --resume" : "");
+    return 1;
+  }
+
+  if (!writeFile(prefix + ".eeprom.bin", image.data() + ExportProtocol::EEPROM_OFFSET, ExportProtocol::EEPROM_BYTES) ||
+      !writeFile(prefix + ".cal.bin", image.data() + ExportProtocol::CALIBRATION_OFFSET,
+                 ExportProtocol::CALIBRATION_BYTES)) {
+    return 1;
+  }
+  unlink(partPath.c_str());
+  return 0;
+}
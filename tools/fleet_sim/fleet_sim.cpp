@@ -0,0 +1,460 @@
+/*
+ * Fleet simulator: runs the real MainController, Logger and Sensor code on simulated hardware for many devices
+ * over years of virtual time, to forecast battery life and EEPROM wear before a firmware change ships.
+ *
+ * Every wake is a full power-on of the firmware: setup() and loop() run until it releases the power latch.
+ * Between wakes only the always-on current of the ATtiny412 timer board is charged. Devices are split across
+ * worker processes (one per core by default) because the firmware keeps state in statics.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "HostBoard.h"
+#include "Controllers/MainController.h"
+
+namespace {
+
+    constexpr double DAY = 86400.0;
+    constexpr double YEAR = 365.25 * DAY;
+    constexpr double WAKE_INTERVAL = 4 * 3600.0; // ATtiny412 WAKE_INTERVAL
+    constexpr double PULSE_LENGTH = 2.0;         // ATtiny412 FLASH_TIME
+    constexpr double MAX_WAKE = 600.0;           // a wake longer than this is reported as stuck
+    constexpr uint8_t PUSH_BUTTON_PIN = 0;       // MainController pins
+    constexpr uint8_t MEASUREMENT_INTERRUPT_PIN = 1;
+    constexpr uint8_t EEPROM_RESET_PIN = 3;
+
+    struct Options {
+        uint32_t devices = 1000;
+        double years = 5.0;
+        unsigned jobs = 0; // 0: one per core
+        uint64_t seed = 1;
+        double capacityMah = 220.0;   // usable CR2032 capacity
+        double sessionsPerDay = 1.0;  // fleet mean of button sessions per day
+        double offUa = 1.5;           // ATtiny412 in power down with the PIT running, plus latch leakage
+        uint32_t tickMs = 5;          // virtual time per loop() iteration
+        uint32_t endurance = 100000;  // EEPROM erase/write cycles per cell
+        const char *cellsCsv = nullptr;
+    };
+
+    /** What one worker sends back per device, plain data so it can go through a pipe. */
+    struct DeviceResult {
+        uint32_t id;
+        uint8_t batteryDied;      // capacity used up within the simulated years
+        double batteryYears;      // time until the capacity is used up, extrapolated if it was not
+        double firstWornYears;    // time until the most written cell reaches the endurance, extrapolated
+        uint32_t wakes;
+        uint32_t sessions;
+        uint32_t stuckWakes;
+        double awakeSeconds;
+        double chargeMah[host::RAIL_COUNT + 1]; // per rail, then the off state
+        uint32_t cellWrites[host::Board::EEPROM_SIZE];
+    };
+
+    /** External pin levels during one wake, times relative to the start of the wake. */
+    struct WakeInputs {
+        std::vector<std::pair<uint64_t, uint64_t>> presses; // button held in [first, second) us
+        uint64_t pulseStart = UINT64_MAX;
+        uint64_t pulseEnd = 0;
+        bool eepromReset = false;
+    };
+
+    int inputLevel(uint8_t pin, uint64_t nowUs, void *context) {
+      const WakeInputs &in = *static_cast<WakeInputs *>(context);
+      switch (pin) {
+        case PUSH_BUTTON_PIN:
+          for (const auto &press : in.presses) {
+            if (nowUs >= press.first && nowUs < press.second) return HIGH;
+          }
+          return LOW;
+        case MEASUREMENT_INTERRUPT_PIN:
+          return (nowUs >= in.pulseStart && nowUs < in.pulseEnd) ? HIGH : LOW;
+        case EEPROM_RESET_PIN:
+          return in.eepromReset ? LOW : -1; // -1: follow the pull-up
+        default:
+          return -1;
+      }
+    }
+
+    /** Synthetic indoor climate of one device: seasonal and daily cycles plus sensor noise. */
+    struct Climate {
+        double baseTemp, seasonalTemp, dailyTemp, baseHum, seasonalHum, phase;
+
+        explicit Climate(std::mt19937_64 &rng) {
+          std::uniform_real_distribution<double> u(0.0, 1.0);
+          baseTemp = 17.0 + 7.0 * u(rng);
+          seasonalTemp = 2.0 + 4.0 * u(rng);
+          dailyTemp = 0.5 + 2.0 * u(rng);
+          baseHum = 35.0 + 25.0 * u(rng);
+          seasonalHum = 5.0 + 10.0 * u(rng);
+          phase = 2 * M_PI * u(rng);
+        }
+
+        void at(double t, std::mt19937_64 &rng, double &temperature, double &humidity) const {
+          std::normal_distribution<double> noise(0.0, 0.3);
+          double season = std::sin(2 * M_PI * t / YEAR + phase);
+          temperature = baseTemp + seasonalTemp * season + dailyTemp * std::sin(2 * M_PI * t / DAY) + noise(rng);
+          humidity = std::clamp(baseHum - seasonalHum * season + 4 * noise(rng), 5.0, 95.0);
+        }
+    };
+
+    /** CR2032 voltage under a light load after `fraction` of its capacity, piecewise from a typical datasheet curve. */
+    uint16_t cellMillivolts(double fraction) {
+      static const double points[][2] = {{0.0, 3100}, {0.1, 2950}, {0.7, 2850}, {0.85, 2750}, {0.95, 2500},
+                                         {1.0, 2000}};
+      if (fraction <= 0) return 3100;
+      for (size_t i = 1; i < sizeof(points) / sizeof(points[0]); i++) {
+        if (fraction <= points[i][0]) {
+          double k = (fraction - points[i - 1][0]) / (points[i][0] - points[i - 1][0]);
+          return (uint16_t) (points[i - 1][1] + k * (points[i][1] - points[i - 1][1]));
+        }
+      }
+      return 2000;
+    }
+
+    /** Run the firmware from power on until it releases the latch. Returns the wake length in seconds. */
+    double runWake(const Options &options, WakeInputs &inputs, bool &stuck) {
+      host::Board &board = host::Board::get();
+      board.powerOn(inputLevel, &inputs);
+      stuck = false;
+      try {
+        MainController controller;
+        controller.setup();
+        while (board.now() < (uint64_t) (MAX_WAKE * 1e6)) {
+          controller.loop();
+          board.advance((uint64_t) options.tickMs * 1000);
+        }
+        stuck = true;
+      } catch (host::PowerCut &) {
+      }
+      return board.now() / 1e6;
+    }
+
+    DeviceResult simulateDevice(const Options &options, uint32_t id) {
+      std::mt19937_64 rng(options.seed * 0x9E3779B97F4A7C15ULL + id);
+      std::uniform_real_distribution<double> u(0.0, 1.0);
+      host::Board &board = host::Board::get();
+
+      DeviceResult result = {};
+      result.id = id;
+      memset(board.eeprom, 0xFF, sizeof(board.eeprom));
+      memset(board.eepromWrites, 0, sizeof(board.eepromWrites));
+      memset(board.chargeUas, 0, sizeof(board.chargeUas));
+
+      Climate climate(rng);
+      double sessionRate = options.sessionsPerDay * (0.25 + 1.75 * u(rng)) / DAY; // per-device habit
+      std::exponential_distribution<double> sessionGap(sessionRate > 0 ? sessionRate : 1e-12);
+
+      double horizon = options.years * YEAR;
+      double capacityUas = options.capacityMah * 3600.0 * 1000.0;
+      double offUas = 0;
+      double t = 0;
+      double nextPulse = WAKE_INTERVAL * u(rng);
+      double nextSession = sessionRate > 0 ? sessionGap(rng) : INFINITY;
+      bool firstBoot = true;
+
+      while (t < horizon) {
+        bool session = nextSession < nextPulse;
+        double start = session ? nextSession : nextPulse;
+        if (start >= horizon) break;
+        offUas += options.offUa * (start - t);
+
+        WakeInputs inputs;
+        inputs.eepromReset = firstBoot;
+        if (session) {
+          // the press that latched the power, then a few screen changes once the 1.5 s lockout is over
+          inputs.presses.emplace_back(0, 300000);
+          int flips = (int) (u(rng) * 5);
+          double at = 1.6;
+          for (int i = 0; i < flips; i++) {
+            at += 0.6 + 2.5 * u(rng);
+            inputs.presses.emplace_back((uint64_t) (at * 1e6), (uint64_t) ((at + 0.15) * 1e6));
+          }
+          if (nextPulse - start < MAX_WAKE) {
+            inputs.pulseStart = (uint64_t) ((nextPulse - start) * 1e6);
+            inputs.pulseEnd = inputs.pulseStart + (uint64_t) (PULSE_LENGTH * 1e6);
+          }
+          result.sessions++;
+        } else {
+          inputs.pulseStart = 0;
+          inputs.pulseEnd = (uint64_t) (PULSE_LENGTH * 1e6);
+        }
+
+        double temperature, humidity;
+        climate.at(start, rng, temperature, humidity);
+        board.sensor.setEnvironment(temperature, humidity);
+
+        double drawn = offUas;
+        for (double rail : board.chargeUas) drawn += rail;
+        board.batteryMillivolts = cellMillivolts(drawn / capacityUas);
+
+        bool stuck;
+        double length = runWake(options, inputs, stuck);
+        result.wakes++;
+        result.stuckWakes += stuck;
+        result.awakeSeconds += length;
+        firstBoot = false;
+
+        t = start + length;
+        while (nextPulse <= t) nextPulse += WAKE_INTERVAL;
+        if (session) nextSession = t + sessionGap(rng);
+
+        double used = offUas;
+        for (double rail : board.chargeUas) used += rail;
+        if (!result.batteryDied && used >= capacityUas) {
+          result.batteryDied = 1;
+          result.batteryYears = t / YEAR;
+        }
+      }
+      if (t < horizon) {
+        offUas += options.offUa * (horizon - t);
+        t = horizon;
+      }
+
+      double used = offUas;
+      for (int rail = 0; rail < host::RAIL_COUNT; rail++) {
+        used += board.chargeUas[rail];
+        result.chargeMah[rail] = board.chargeUas[rail] / 3.6e6;
+      }
+      result.chargeMah[host::RAIL_COUNT] = offUas / 3.6e6;
+      if (!result.batteryDied) result.batteryYears = (t / YEAR) * capacityUas / used;
+
+      uint32_t mostWritten = 0;
+      for (uint16_t i = 0; i < host::Board::EEPROM_SIZE; i++) {
+        result.cellWrites[i] = board.eepromWrites[i];
+        mostWritten = std::max(mostWritten, board.eepromWrites[i]);
+      }
+      result.firstWornYears = mostWritten ? (t / YEAR) * options.endurance / mostWritten : INFINITY;
+      return result;
+    }
+
+    /** Run devices id = worker, worker + jobs, ... and write each result to fd. */
+    void runWorker(const Options &options, unsigned worker, unsigned jobs, int fd) {
+      for (uint32_t id = worker; id < options.devices; id += jobs) {
+        DeviceResult result = simulateDevice(options, id);
+        const char *bytes = reinterpret_cast<const char *>(&result);
+        for (size_t done = 0; done < sizeof(result);) {
+          ssize_t n = write(fd, bytes + done, sizeof(result) - done);
+          if (n <= 0) _exit(1);
+          done += n;
+        }
+      }
+      close(fd);
+    }
+
+    /** Fork the workers and collect all results. */
+    std::vector<DeviceResult> runFleet(const Options &options, unsigned jobs) {
+      std::vector<int> fds;
+      std::vector<pid_t> pids;
+      for (unsigned worker = 0; worker < jobs; worker++) {
+        int pipeFds[2];
+        if (pipe(pipeFds) != 0) {
+          perror("pipe");
+          exit(1);
+        }
+        pid_t pid = fork();
+        if (pid < 0) {
+          perror("fork");
+          exit(1);
+        }
+        if (pid == 0) {
+          close(pipeFds[0]);
+          for (int fd : fds) close(fd);
+          runWorker(options, worker, jobs, pipeFds[1]);
+          _exit(0);
+        }
+        close(pipeFds[1]);
+        fds.push_back(pipeFds[0]);
+        pids.push_back(pid);
+      }
+
+      std::vector<DeviceResult> results;
+      std::vector<std::vector<char>> partial(jobs);
+      std::vector<pollfd> polls;
+      for (int fd : fds) polls.push_back({fd, POLLIN, 0});
+      size_t open = polls.size();
+      char buffer[1 << 16];
+      while (open) {
+        if (poll(polls.data(), polls.size(), -1) < 0) {
+          perror("poll");
+          exit(1);
+        }
+        for (size_t i = 0; i < polls.size(); i++) {
+          if (polls[i].fd < 0 || !(polls[i].revents & (POLLIN | POLLHUP))) continue;
+          ssize_t n = read(polls[i].fd, buffer, sizeof(buffer));
+          if (n <= 0) {
+            close(polls[i].fd);
+            polls[i].fd = -1;
+            open--;
+            continue;
+          }
+          partial[i].insert(partial[i].end(), buffer, buffer + n);
+          size_t whole = partial[i].size() / sizeof(DeviceResult);
+          for (size_t k = 0; k < whole; k++) {
+            DeviceResult result;
+            memcpy(&result, partial[i].data() + k * sizeof(DeviceResult), sizeof(result));
+            results.push_back(result);
+          }
+          partial[i].erase(partial[i].begin(), partial[i].begin() + whole * sizeof(DeviceResult));
+        }
+        fprintf(stderr, "\r%zu/%u devices", results.size(), options.devices);
+      }
+      fprintf(stderr, "\n");
+
+      for (pid_t pid : pids) {
+        int status;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+          fprintf(stderr, "worker %d failed\n", (int) pid);
+          exit(1);
+        }
+      }
+      std::sort(results.begin(), results.end(), [](const DeviceResult &a, const DeviceResult &b) {
+        return a.id < b.id;
+      });
+      return results;
+    }
+
+    void printDistribution(const char *label, std::vector<double> values) {
+      std::sort(values.begin(), values.end());
+      auto pct = [&](double p) {
+        return values[std::min(values.size() - 1, (size_t) (p / 100.0 * values.size()))];
+      };
+      double sum = 0;
+      for (double v : values) sum += v;
+      printf("  %-22s%8.2f%8.2f%8.2f%8.2f%8.2f%8.2f%8.2f%9.2f\n", label,
+             pct(1), pct(5), pct(25), pct(50), pct(75), pct(95), pct(99), sum / values.size());
+    }
+
+    void report(const Options &options, const std::vector<DeviceResult> &results) {
+      size_t n = results.size();
+      const char *header = "                            p1      p5     p25     p50     p75     p95     p99     mean\n";
+
+      std::vector<double> battery, worn;
+      uint32_t died = 0, stuck = 0;
+      double wakes = 0, sessions = 0, awake = 0;
+      double charge[host::RAIL_COUNT + 1] = {};
+      for (const DeviceResult &r : results) {
+        battery.push_back(r.batteryYears);
+        worn.push_back(r.firstWornYears);
+        died += r.batteryDied;
+        stuck += r.stuckWakes;
+        wakes += r.wakes;
+        sessions += r.sessions;
+        awake += r.awakeSeconds;
+        for (int i = 0; i <= host::RAIL_COUNT; i++) charge[i] += r.chargeMah[i];
+      }
+
+      printf("\nBattery life, years (%.0f mAh, extrapolated where the battery outlived the run)\n", options.capacityMah);
+      printf("%s", header);
+      printDistribution("time to battery death", battery);
+      printf("  %u of %zu batteries died within %.1f years\n", died, n, options.years);
+
+      printf("\nEEPROM wear, years until the most written cell reaches %u cycles\n", options.endurance);
+      printf("%s", header);
+      printDistribution("time to first worn cell", worn);
+
+      double deviceYears = n * options.years;
+      printf("\nCharge per device per year, mAh\n");
+      const char *rails[] = {"mcu", "display", "sensor", "eeprom", "off (timer board)"};
+      double total = 0;
+      for (double c : charge) total += c;
+      for (int i = 0; i <= host::RAIL_COUNT; i++) {
+        printf("  %-22s%8.3f  (%4.1f%%)\n", rails[i], charge[i] / deviceYears, 100.0 * charge[i] / total);
+      }
+      printf("  %-22s%8.3f\n", "total", total / deviceYears);
+
+      printf("\nWakes per device per day: %.2f (%.2f button sessions), awake %.1f s/day, %u stuck wakes\n",
+             wakes / (deviceYears * 365.25), sessions / (deviceYears * 365.25), awake / (deviceYears * 365.25), stuck);
+
+      std::vector<std::pair<double, uint16_t>> cells;
+      for (uint16_t a = 0; a < host::Board::EEPROM_SIZE; a++) {
+        double sum = 0;
+        for (const DeviceResult &r : results) sum += r.cellWrites[a];
+        cells.emplace_back(sum / deviceYears, a);
+      }
+      std::sort(cells.rbegin(), cells.rend());
+      printf("\nMost written EEPROM cells, mean writes per device per year\n");
+      for (int i = 0; i < 5 && cells[i].first > 0; i++) {
+        printf("  address %3u  %10.1f\n", cells[i].second, cells[i].first);
+      }
+
+      if (options.cellsCsv) {
+        FILE *f = fopen(options.cellsCsv, "w");
+        if (!f) {
+          perror(options.cellsCsv);
+          exit(1);
+        }
+        fprintf(f, "address,mean_writes_per_year,max_writes_per_year\n");
+        for (uint16_t a = 0; a < host::Board::EEPROM_SIZE; a++) {
+          double sum = 0, most = 0;
+          for (const DeviceResult &r : results) {
+            sum += r.cellWrites[a];
+            most = std::max(most, (double) r.cellWrites[a]);
+          }
+          fprintf(f, "%u,%.2f,%.2f\n", a, sum / deviceYears, most / options.years);
+        }
+        fclose(f);
+      }
+    }
+
+    void usage(const char *argv0) {
+      fprintf(stderr,
+              "usage: %s [options]\n"
+              "  --devices N           devices to simulate (1000)\n"
+              "  --years Y             virtual time per device (5)\n"
+              "  --jobs J              worker processes (one per core)\n"
+              "  --seed S              random seed (1)\n"
+              "  --capacity-mah C      usable battery capacity (220)\n"
+              "  --sessions-per-day R  fleet mean of button sessions per day (1.0)\n"
+              "  --off-ua I            current while the latch is off (1.5)\n"
+              "  --tick-ms T           virtual time per loop() call (5)\n"
+              "  --endurance E         EEPROM cycles per cell (100000)\n"
+              "  --cells FILE          write per-cell write rates as CSV\n", argv0);
+      exit(2);
+    }
+
+}
+
+int main(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (i + 1 >= argc) usage(argv[0]);
+    const char *value = argv[++i];
+    if (arg == "--devices") options.devices = strtoul(value, nullptr, 10);
+    else if (arg == "--years") options.years = atof(value);
+    else if (arg == "--jobs") options.jobs = strtoul(value, nullptr, 10);
+    else if (arg == "--seed") options.seed = strtoull(value, nullptr, 10);
+    else if (arg == "--capacity-mah") options.capacityMah = atof(value);
+    else if (arg == "--sessions-per-day") options.sessionsPerDay = atof(value);
+    else if (arg == "--off-ua") options.offUa = atof(value);
+    else if (arg == "--tick-ms") options.tickMs = strtoul(value, nullptr, 10);
+    else if (arg == "--endurance") options.endurance = strtoul(value, nullptr, 10);
+    else if (arg == "--cells") options.cellsCsv = value;
+    else usage(argv[0]);
+  }
+  if (options.devices == 0 || options.years <= 0 || options.tickMs == 0) usage(argv[0]);
+
+  unsigned jobs = options.jobs ? options.jobs : std::max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+  jobs = std::min<unsigned>(jobs, options.devices);
+
+  auto started = std::chrono::steady_clock::now();
+  std::vector<DeviceResult> results = runFleet(options, jobs);
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+  printf("Simulated %u devices for %.1f years each on %u processes in %.1f s\n",
+         options.devices, options.years, jobs, seconds);
+  report(options, results);
+  return 0;
+}
@@ -0,0 +1,88 @@
+/*
+ * font_report: flash cost of the generated font tables against what they save at draw time.
+ *
+ * The table sizes are host estimates: sizeof() of the same constexpr tables Display stores, built by the host
+ * compiler. They hold only bytes, so they should match the AVR image, but the linker map or avr-size of a target
+ * build is what counts. The "pre-scaled bitmaps" line is computed, not built. The draw figures come from running
+ * the firmware Display on the simulated board, so they count U8g2 primitives and bus traffic, not AVR cycles;
+ * use the Benchmark environment for those and `pio run -e MainBoard -v` / avr-size for the whole image.
+*/
+
+#include <cstdio>
+#include "Arduino.h"
+#include "HostBoard.h"
+#include "Display/Display.h"
+#include "Logger/Logger.h"
+#include "Display/FontTables.h"
+
+namespace {
+
+    struct Frame {
+        uint32_t drawCalls;
+        uint32_t pages;
+        uint32_t tiles;
+        uint64_t us;
+    };
+
+    template<typename F>
+    Frame measure(F draw) {
+      host::Board &board = host::Board::get();
+      uint32_t calls = board.drawCalls, pages = board.pagesSent, tiles = board.tilesSent;
+      uint64_t started = board.now();
+      draw();
+      return {board.drawCalls - calls, board.pagesSent - pages, board.tilesSent - tiles, board.now() - started};
+    }
+
+    void printFrame(const char *name, const Frame &frame) {
+      printf("  %-28s%8u%8u%8u%10.2f\n", name, frame.drawCalls, frame.pages, frame.tiles, frame.us / 1000.0);
+    }
+
+    int noInputs(uint8_t, uint64_t, void *) { return -1; }
+
+}
+
+int main() {
+  constexpr auto columns = Font::columnTable();
+  constexpr auto chars = Font::charTable();
+  constexpr auto xbm = Font::xbmTable();
+  constexpr auto spread2 = Font::spreadTable<2>();
+  constexpr auto spread4 = Font::spreadTable<4>();
+  constexpr auto labels = sizeof(Font::glyphs("TEMP")) + sizeof(Font::glyphs("HUMID")) + sizeof(Font::glyphs("7D"));
+  size_t total = sizeof(columns) + sizeof(chars) + sizeof(xbm) + sizeof(spread2) + sizeof(spread4) + labels;
+
+  printf("Font tables in flash (bytes, host estimates: sizeof() in this build, check avr-size for the target)\n");
+  printf("  %-28s%6zu  (the original font)\n", "glyph columns", sizeof(columns));
+  printf("  %-28s%6zu  ('%c'..'%c' to glyph index)\n", "character table", sizeof(chars), Font::FIRST_CHAR,
+         Font::LAST_CHAR);
+  printf("  %-28s%6zu  (scale 1 glyphs, one drawXBMP each)\n", "XBM glyphs", sizeof(xbm));
+  printf("  %-28s%6zu\n", "2x spread table", sizeof(spread2));
+  printf("  %-28s%6zu\n", "4x spread table", sizeof(spread4));
+  printf("  %-28s%6zu  (TEMP, HUMID, 7D)\n", "label glyph strings", labels);
+  printf("  %-28s%6zu  (%zu on top of the original font)\n", "total", total, total - sizeof(columns));
+
+  // what fully pre-scaled bitmaps of the glyphs each scale draws would take instead of the spread tables
+  size_t readoutGlyphs = 14; // 0-9 . d % -
+  size_t scale4 = readoutGlyphs * ((Font::WIDTH * 4 + 7) / 8) * Font::HEIGHT * 4;
+  size_t scale2 = 2 * ((Font::WIDTH * 2 + 7) / 8) * Font::HEIGHT * 2;
+  printf("  %-28s%6zu  (computed: scale 4 readout glyphs and the 2x T/H labels as XBM)\n",
+         "pre-scaled bitmaps would be",
+         scale4 + scale2);
+
+  host::Board &board = host::Board::get();
+  board.powerOn(noInputs, nullptr);
+  Display display;
+  display.setup();
+  Logger history;
+  history.begin();
+  for (int i = 0; i < 28; i++) history.push(18.0f + (i % 7) * 0.8f, 18.0f + (i % 7) * 0.8f);
+
+  printf("\nPer frame on the simulated board\n");
+  printf("  %-28s%8s%8s%8s%10s\n", "frame", "draws", "pages", "tiles", "ms");
+  printFrame("main, full", measure([&] { display.displayMain(21.37f, 45.6f); }));
+  printFrame("main, one digit changed", measure([&] { display.displayMain(21.47f, 45.6f); }));
+  printFrame("main, unchanged", measure([&] { display.displayMain(21.47f, 45.6f); }));
+  printFrame("main, both lines changed", measure([&] { display.displayMain(-4.2f, 100.0f); }));
+  printFrame("temperature chart", measure([&] { display.displayChart(history, LoggerCodec::TEMPERATURE); }));
+  printFrame("humidity chart", measure([&] { display.displayChart(history, LoggerCodec::HUMIDITY); }));
+  return 0;
+}
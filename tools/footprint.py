@@ -0,0 +1,336 @@
+#!/usr/bin/env python3
+"""
+Flash, RAM and stack footprint of a firmware build, checked against tools/footprint_budget.json.
+
+Normally run through PlatformIO once tools/footprint_target.py is in the env's extra_scripts (it also adds the
+flags it needs):
+
+    pio run -e MainBoard -t footprint
+
+or by hand on a build directory:
+
+    footprint.py --elf .pio/build/MainBoard/firmware.elf [--map .pio/build/MainBoard/firmware.map] \\
+                 [--su-dir .pio/build/MainBoard] [--budget tools/footprint_budget.json] [--update-budget]
+
+Totals come from the ELF sections. Symbols are attributed to modules (firmware directory, library, framework) by
+the source file in their debug info, falling back to the object file named in the map file, so attribution
+still works after link time optimisation has merged the objects.
+
+The stack estimate is the deepest call chain from main() plus the deepest interrupt handler. Frame sizes come
+from -fstack-usage (.su files) where the compiler wrote them and otherwise from the pushes and frame allocation in
+each function's prologue; calls come from the disassembly. Calls through pointers cannot be followed, so list
+their targets under "indirect_calls" in the budget file; the rest are charged "indirect_fallback" bytes and
+listed in the report. Exits with status 1 if anything is over budget, or if the budget was never generated from a
+build (it has no per-module caps): the part limits alone could never fail, so run --update-budget on a known good
+build and commit the result first.
+"""
+
+import argparse
+import glob
+import json
+import os
+import re
+import subprocess
+import sys
+
+FLASH_SECTIONS = (".text", ".rodata", ".progmem", ".data")  # .data is in flash as the initial values
+RAM_SECTIONS = (".data", ".bss", ".noinit")
+RETURN_ADDRESS = 2  # bytes pushed per call on a part with <= 128 KB of flash
+BUDGET_ROUNDING = 64
+BUDGET_HEADROOM = 1.10
+
+
+def run(command):
+    return subprocess.run(command, check=True, capture_output=True, text=True).stdout
+
+
+def in_flash(section):
+    return section.startswith(FLASH_SECTIONS)
+
+
+def in_ram(section):
+    return section.startswith(RAM_SECTIONS)
+
+
+def base_name(name):
+    """Function name without return type or parameters, so names from .su files and objdump -C match."""
+    depth = 0
+    for i, ch in enumerate(name):
+        if ch == "<":
+            depth += 1
+        elif ch == ">":
+            depth -= 1
+        elif ch == "(" and depth == 0:
+            name = name[:i]
+            break
+    parts = re.split(r"\s+(?![^<]*>)", name.strip())
+    return parts[-1] if parts else name
+
+
+def module_of(path):
+    """Firmware directory, library or framework a source or object file belongs to."""
+    path = "/" + path.replace("\\", "/").split(":")[0].lstrip("/")
+    archive = re.search(r"/lib([^/()]+)\.a(\(.*\))?$", path)
+    if archive:
+        name = archive.group(1)
+        return "framework" if name.startswith("FrameworkArduino") else name
+    if "/framework-" in path or "/FrameworkArduino/" in path:
+        return "framework"
+    if "/libdeps/" in path:
+        return path.split("/libdeps/", 1)[1].split("/")[1]
+    if "/src/" in path:
+        rest = path.rsplit("/src/", 1)[1]
+        return rest.split("/", 1)[0] if "/" in rest else "main"
+    return "other"
+
+
+# ---- sizes and symbols ----
+
+def totals(size_tool, elf):
+    """(flash, static ram) from the section sizes."""
+    flash = ram = 0
+    for line in run([size_tool, "-A", elf]).splitlines():
+        fields = line.split()
+        if len(fields) >= 2 and fields[0].startswith(".") and fields[1].isdigit():
+            flash += int(fields[1]) if in_flash(fields[0]) else 0
+            ram += int(fields[1]) if in_ram(fields[0]) else 0
+    return flash, ram
+
+
+def map_objects(map_path):
+    """{symbol: object file} from the symbol lines under each input section of a GNU ld map file."""
+    objects = {}
+    current = None
+    with open(map_path, errors="replace") as f:
+        for line in f:
+            entry = re.match(r"^ (?:\.\S+|COMMON)?\s+0x[0-9a-fA-F]+\s+0x[0-9a-fA-F]+\s+(\S.*)$", line)
+            if entry:
+                current = entry.group(1).strip()
+                continue
+            symbol = re.match(r"^\s+0x[0-9a-fA-F]+\s+([^\s=].*)$", line)
+            if symbol and current and "=" not in line:
+                objects[symbol.group(1).strip()] = current
+    return objects
+
+
+def symbols(nm, elf, objects):
+    """[(name, module, flash, ram)] for every sized symbol."""
+    result = []
+    for line in run([nm, "-C", "-S", "-l", "--format=sysv", elf]).splitlines():
+        fields = [f.strip() for f in line.split("|")]
+        if len(fields) < 7 or not fields[4]:
+            continue
+        name, size, section = fields[0], int(fields[4], 16), fields[6].split("\t")[0].strip()
+        source = fields[6].split("\t", 1)[1] if "\t" in fields[6] else ""
+        flash = size if in_flash(section) else 0
+        ram = size if in_ram(section) else 0
+        if not (flash or ram):
+            continue
+        if source:
+            module = module_of(source)
+        elif name in objects:
+            module = module_of(objects[name])
+        else:
+            module = "other"
+        result.append((name, module, flash, ram))
+    return result
+
+
+# ---- stack ----
+
+def su_frames(su_dir):
+    """{function: frame bytes} from -fstack-usage output, plus the functions with unbounded frames."""
+    frames, dynamic = {}, set()
+    for path in glob.glob(os.path.join(su_dir, "**", "*.su"), recursive=True):
+        with open(path, errors="replace") as f:
+            for line in f:
+                fields = line.rstrip("\n").split("\t")
+                if len(fields) < 3:
+                    continue
+                name = base_name(fields[0].split(":", 3)[-1])
+                frames[name] = max(frames.get(name, 0), int(fields[1]))
+                if "dynamic" in fields[2] and "bounded" not in fields[2]:
+                    dynamic.add(name)
+    return frames, dynamic
+
+
+def disassemble(objdump, elf):
+    """Call graph, pointer calls and prologue frame sizes of every function."""
+    calls, indirect, frames = {}, set(), {}
+    current = None
+    in_prologue = False
+    header = re.compile(r"^[0-9a-fA-F]+ <(.+)>:$")
+    direct = re.compile(r"\b(r?call|callq?|r?jmp|jmpq?)\b.*<([^>]+)>")
+    pointer = re.compile(r"\b(e?icall|e?ijmp|callq?\s+\*)")
+    for line in run([objdump, "-d", "-C", elf]).splitlines():
+        match = header.match(line)
+        if match:
+            current = base_name(match.group(1))
+            calls.setdefault(current, set())
+            frames.setdefault(current, 0)
+            in_prologue = True
+            continue
+        if current is None or "\t" not in line:
+            continue
+        instruction = line.split("\t", 2)[-1].strip()
+
+        # avr-gcc prologue: register pushes, "rcall .+0" for small frames, then SP moved down by N
+        if in_prologue:
+            if instruction.startswith("push"):
+                frames[current] += 1
+                continue
+            if re.match(r"rcall\s+\.\+0\b", instruction):
+                frames[current] += RETURN_ADDRESS
+                continue
+            adjust = re.match(r"(?:sbiw|subi)\s+r28,\s*0x([0-9a-fA-F]+)", instruction)
+            if adjust:
+                frames[current] += int(adjust.group(1), 16)
+                continue
+            if not re.match(r"(in|out|cli|sei|sbci|mov|movw|clr|eor|ldi)\b", instruction):
+                in_prologue = False
+
+        if pointer.search(instruction):
+            indirect.add(current)
+            continue
+        match = direct.search(instruction)
+        if match:
+            target = match.group(2)
+            if "+0x" in target:
+                continue  # a branch inside a function
+            target = base_name(target)
+            if target != current:
+                calls[current].add(target)
+    return calls, indirect, frames
+
+
+def deepest(root, frames, calls, indirect, hints, fallback, notes):
+    """(bytes, chain) of the deepest call chain from root."""
+    memo = {}
+    on_path = set()
+
+    def visit(name):
+        if name in memo:
+            return memo[name]
+        if name in on_path:
+            notes.add(f"recursion through {name}, counted once")
+            return 0, [name]
+        on_path.add(name)
+        best, chain = 0, []
+        for callee in calls.get(name, set()) | hints.get(name, set()):
+            depth, sub = visit(callee)
+            if depth + RETURN_ADDRESS > best:
+                best, chain = depth + RETURN_ADDRESS, sub
+        if name in indirect and name not in hints:
+            notes.add(f"{name} calls through a pointer, charged {fallback} bytes")
+            if fallback > best:
+                best, chain = fallback, ["<pointer call>"]
+        on_path.discard(name)
+        memo[name] = (frames.get(name, 0) + best, [name] + chain)
+        return memo[name]
+
+    return visit(root)
+
+
+# ---- report ----
+
+def rounded(value, limit):
+    value = -(-int(value * BUDGET_HEADROOM) // BUDGET_ROUNDING) * BUDGET_ROUNDING
+    return min(value, limit)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--elf", required=True)
+    parser.add_argument("--map", help="linker map file (-Wl,-Map), for symbols without debug info")
+    parser.add_argument("--su-dir", help="directory searched for -fstack-usage .su files")
+    parser.add_argument("--budget", default=os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                                         "footprint_budget.json"))
+    parser.add_argument("--toolchain-prefix", default="avr-", help="prefix of nm, objdump and size (avr-)")
+    parser.add_argument("--top", type=int, default=15, help="number of largest symbols to list")
+    parser.add_argument("--update-budget", action="store_true",
+                        help="rewrite the budget from this build plus 10%% headroom instead of checking it")
+    args = parser.parse_args()
+
+    with open(args.budget) as f:
+        budget = json.load(f)
+    tool = lambda name: args.toolchain_prefix + name
+
+    flash, static_ram = totals(tool("size"), args.elf)
+    objects = map_objects(args.map) if args.map else {}
+    symbol_list = symbols(tool("nm"), args.elf, objects)
+    modules = {}
+    for _, module, f_bytes, r_bytes in symbol_list:
+        modules.setdefault(module, [0, 0])
+        modules[module][0] += f_bytes
+        modules[module][1] += r_bytes
+    attributed = [sum(m[0] for m in modules.values()), sum(m[1] for m in modules.values())]
+    if flash > attributed[0] or static_ram > attributed[1]:
+        modules["(no symbol)"] = [max(flash - attributed[0], 0), max(static_ram - attributed[1], 0)]
+
+    calls, indirect, frames = disassemble(tool("objdump"), args.elf)
+    notes = set()
+    if args.su_dir:
+        su, dynamic = su_frames(args.su_dir)
+        frames.update(su)
+        notes.update(f"{name} has a dynamic stack frame" for name in dynamic)
+    hints = {name: set(targets) for name, targets in budget.get("indirect_calls", {}).items()}
+    fallback = budget.get("indirect_fallback", 0)
+    main_depth, main_chain = deepest("main", frames, calls, indirect, hints, fallback, notes)
+    isr_depth, isr_chain = 0, []
+    for name in sorted(calls):
+        if name.startswith("__vector_"):
+            depth, chain = deepest(name, frames, calls, indirect, hints, fallback, notes)
+            if depth + RETURN_ADDRESS > isr_depth:
+                isr_depth, isr_chain = depth + RETURN_ADDRESS, chain
+    stack = main_depth + isr_depth
+
+    print(f"{'symbol':<56}{'module':<14}{'flash':>7}{'ram':>7}")
+    for name, module, f_bytes, r_bytes in sorted(symbol_list, key=lambda s: -(s[2] + s[3]))[:args.top]:
+        print(f"{name[:55]:<56}{module[:13]:<14}{f_bytes:>7}{r_bytes:>7}")
+    print(f"\n{'module':<30}{'flash':>7}{'ram':>7}")
+    for name, (f_bytes, r_bytes) in sorted(modules.items(), key=lambda m: -(m[1][0] + m[1][1])):
+        print(f"{name:<30}{f_bytes:>7}{r_bytes:>7}")
+    print(f"\nworst-case stack {stack} bytes: {main_depth} from main, {isr_depth} for the deepest interrupt")
+    print("  main:      " + " > ".join(main_chain))
+    if isr_chain:
+        print("  interrupt: " + " > ".join(isr_chain))
+    for note in sorted(notes):
+        print(f"  note: {note}")
+
+    usage = {"flash": flash, "static_ram": static_ram, "stack": stack, "ram": static_ram + stack}
+    print(f"\n{'':<12}{'used':>7}{'budget':>8}")
+    for key, used in usage.items():
+        print(f"{key:<12}{used:>7}{budget.get(key, '-'):>8}")
+
+    if args.update_budget:
+        budget["flash"] = rounded(flash, budget["flash_limit"])
+        budget["static_ram"] = rounded(static_ram, budget["ram_limit"])
+        budget["stack"] = rounded(stack, budget["ram_limit"])
+        budget["ram"] = min(budget["static_ram"] + budget["stack"], budget["ram_limit"])
+        budget["modules"] = {name: rounded(f_bytes, budget["flash_limit"])
+                             for name, (f_bytes, _) in sorted(modules.items()) if f_bytes}
+        with open(args.budget, "w") as f:
+            json.dump(budget, f, indent=2)
+            f.write("\n")
+        print(f"\nbudget written to {args.budget}")
+        return 0
+
+    if not budget.get("modules"):
+        print(f"\nbudget has no per-module caps, so it was never generated from a build; run with --update-budget on "
+              f"a known good build and commit {args.budget}", file=sys.stderr)
+        return 1
+
+    over = [f"{key} {used} > {budget[key]}" for key, used in usage.items() if key in budget and used > budget[key]]
+    for name, limit in budget.get("modules", {}).items():
+        used = modules.get(name, [0, 0])[0]
+        if used > limit:
+            over.append(f"module {name} flash {used} > {limit}")
+    if over:
+        print("\nover budget: " + ", ".join(over), file=sys.stderr)
+        return 1
+    print("\nwithin budget")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
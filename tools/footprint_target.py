@@ -0,0 +1,29 @@
+"""
+PlatformIO extra script adding a `footprint` target that runs tools/footprint.py on the build. It is not in
+platformio.ini until tools/footprint_budget.json has been generated from a build (see README, Performance); add
+`extra_scripts = post:tools/footprint_target.py` to an env, then:
+
+    pio run -e MainBoard -t footprint
+
+It also turns on the stack usage output and the linker map file that the report reads.
+"""
+
+Import("env")  # noqa: F821 (provided by PlatformIO)
+
+env.Append(  # noqa: F821
+    CCFLAGS=["-fstack-usage"],
+    LINKFLAGS=["-Wl,-Map,${BUILD_DIR}/${PROGNAME}.map"],
+)
+
+toolchain_prefix = env.subst("$CC")[:-len("gcc")]  # noqa: F821 (avr-gcc -> avr-)
+
+env.AddCustomTarget(  # noqa: F821
+    name="footprint",
+    dependencies="$BUILD_DIR/${PROGNAME}.elf",
+    actions=[
+        '"$PYTHONEXE" "$PROJECT_DIR/tools/footprint.py" --elf "$BUILD_DIR/${PROGNAME}.elf" '
+        '--map "$BUILD_DIR/${PROGNAME}.map" --su-dir "$BUILD_DIR" --toolchain-prefix "%s"' % toolchain_prefix
+    ],
+    title="Footprint",
+    description="Flash, RAM and stack attribution checked against tools/footprint_budget.json",
+)
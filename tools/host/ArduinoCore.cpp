@@ -0,0 +1,210 @@
+/*
+ * Host implementations of the Arduino core, Wire, EEPROM and U8g2 stand-ins, forwarding to host::Board.
+*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <EEPROM.h>
+#include <U8g2lib.h>
+#include <avr/wdt.h>
+#include <avr/sleep.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "HostBoard.h"
+
+using host::Board;
+
+RSTCTRL_t RSTCTRL;
+WDT_t WDT;
+NVMCTRL_t NVMCTRL;
+VREF_t VREF;
+TWI_t TWI0;
+
+// ---- core ----
+
+void pinMode(uint8_t pin, uint8_t mode) { Board::get().pinMode(pin, mode); }
+
+void digitalWrite(uint8_t pin, uint8_t value) { Board::get().digitalWrite(pin, value); }
+
+int digitalRead(uint8_t pin) { return Board::get().digitalRead(pin); }
+
+unsigned long millis() { return (unsigned long) (Board::get().now() / 1000); }
+
+unsigned long micros() { return (unsigned long) Board::get().now(); }
+
+void delay(unsigned long ms) {
+  Board::get().advance((uint64_t) ms * 1000);
+  if (Board::get().wallClockDelays) usleep(ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us) { Board::get().advance(us); }
+
+void analogReference(uint8_t) {}
+
+int analogRead(uint8_t pin) { return pin == ADC_INTREF ? Board::get().adcInternalReference() : 0; }
+
+void wdt_reset() {}
+
+void sleep_cpu() { throw host::PowerCut(); }
+
+// ---- Serial ----
+
+HardwareSerial Serial;
+
+void HardwareSerial::begin(uint32_t baud) { Board::get().serialBegin(baud); }
+
+void HardwareSerial::end() {}
+
+size_t HardwareSerial::write(uint8_t value) { return write(&value, 1); }
+
+size_t HardwareSerial::write(const uint8_t *data, size_t length) {
+  Board::get().serialWrite(data, length);
+  return length;
+}
+
+int HardwareSerial::available() { return Board::get().serialAvailable(); }
+
+int HardwareSerial::read() { return Board::get().serialRead(); }
+
+void HardwareSerial::flush() {}
+
+size_t HardwareSerial::print(const __FlashStringHelper *text) { return print(reinterpret_cast<const char *>(text)); }
+
+size_t HardwareSerial::print(const char *text) { return write(reinterpret_cast<const uint8_t *>(text), strlen(text)); }
+
+size_t HardwareSerial::print(char c) { return write((uint8_t) c); }
+
+size_t HardwareSerial::print(unsigned long value) {
+  char digits[24];
+  snprintf(digits, sizeof(digits), "%lu", value);
+  return print(digits);
+}
+
+size_t HardwareSerial::println(const __FlashStringHelper *text) { return print(text) + print("\r\n"); }
+
+size_t HardwareSerial::println(unsigned long value) { return print(value) + print("\r\n"); }
+
+// ---- Wire ----
+
+TwoWire Wire;
+
+void TwoWire::begin() {}
+
+void TwoWire::end() {}
+
+void TwoWire::setClock(uint32_t) {}
+
+void TwoWire::beginTransmission(uint8_t addr) {
+  address = addr;
+  txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t value) {
+  if (txLength >= BUFFER_SIZE) return 0;
+  txBuffer[txLength++] = value;
+  return 1;
+}
+
+uint8_t TwoWire::endTransmission(bool) {
+  return Board::get().i2cWrite(address, txBuffer, txLength) ? 0 : 2; // 2: address NACK
+}
+
+uint8_t TwoWire::requestFrom(int addr, int quantity, bool) {
+  if (quantity > BUFFER_SIZE) quantity = BUFFER_SIZE;
+  rxIndex = 0;
+  rxLength = Board::get().i2cRead(addr, rxBuffer, quantity) ? quantity : 0;
+  return rxLength;
+}
+
+int TwoWire::available() { return rxLength - rxIndex; }
+
+int TwoWire::read() { return rxIndex < rxLength ? rxBuffer[rxIndex++] : -1; }
+
+// ---- EEPROM ----
+
+EEPROMClass EEPROM;
+
+uint8_t EEPROMClass::read(int address) { return Board::get().eepromRead(address); }
+
+void EEPROMClass::write(int address, uint8_t value) { Board::get().eepromWrite(address, value); }
+
+void EEPROMClass::update(int address, uint8_t value) {
+  if (read(address) != value) write(address, value);
+}
+
+uint16_t EEPROMClass::length() { return Board::EEPROM_SIZE; }
+
+// The page buffer starts as a copy of the EEPROM, so the bytes that differ at PAGEERASEWRITE are the loaded ones.
+// EepromStorage only loads bytes that change, so this matches the hardware for everything the firmware does.
+uint8_t host::mappedEeprom[256];
+
+void host::nvmCommand(uint8_t command) {
+  Board &board = Board::get();
+  if (command == NVMCTRL_CMD_PAGEBUFCLR_gc) {
+    memcpy(mappedEeprom, board.eeprom, sizeof(mappedEeprom));
+  } else if (command == NVMCTRL_CMD_PAGEERASEWRITE_gc) {
+    board.eepromPageWrite(mappedEeprom);
+  }
+}
+
+// ---- U8g2 ----
+
+const u8g2_cb_t u8g2_cb_r0 = {};
+
+static uint8_t pageBuffer[128]; // the _1_ variant renders one 8-row page at a time
+
+bool U8G2_SSD1306_128X64_NONAME_1_HW_I2C::begin() {
+  memset(Board::get().panel, 0, sizeof(Board::get().panel)); // begin() clears the display
+  Board::get().displayPower(true);
+  return true;
+}
+
+void U8G2_SSD1306_128X64_NONAME_1_HW_I2C::setPowerSave(uint8_t on) { Board::get().displayPower(!on); }
+
+void U8G2_SSD1306_128X64_NONAME_1_HW_I2C::firstPage() {
+  page = 0;
+  memset(pageBuffer, 0, sizeof(pageBuffer));
+}
+
+uint8_t U8G2_SSD1306_128X64_NONAME_1_HW_I2C::nextPage() {
+  Board::get().displayPage(page, pageBuffer);
+  memset(pageBuffer, 0, sizeof(pageBuffer));
+  return ++page < 8;
+}
+
+void U8G2_SSD1306_128X64_NONAME_1_HW_I2C::drawBox(int x, int y, int w, int h) {
+  Board::get().drawCall();
+  int top = page * 8;
+  for (int row = (y > top ? y : top); row < y + h && row < top + 8; row++) {
+    for (int col = (x > 0 ? x : 0); col < x + w && col < 128; col++) {
+      pageBuffer[col] |= 1 << (row - top);
+    }
+  }
+}
+
+void U8G2_SSD1306_128X64_NONAME_1_HW_I2C::drawLine(int x0, int y0, int x1, int y1) {
+  // the firmware only draws horizontal and vertical lines
+  int x = x0 < x1 ? x0 : x1;
+  int y = y0 < y1 ? y0 : y1;
+  int w = (x0 < x1 ? x1 - x0 : x0 - x1) + 1;
+  int h = (y0 < y1 ? y1 - y0 : y0 - y1) + 1;
+  drawBox(x, y, w, h);
+}
+
+void U8G2_SSD1306_128X64_NONAME_1_HW_I2C::drawXBMP(int x, int y, int w, int h, const uint8_t *bitmap) {
+  Board::get().drawCall();
+  int top = page * 8;
+  int rowBytes = (w + 7) / 8;
+  for (int row = (y > top ? y : top); row < y + h && row < top + 8; row++) {
+    for (int col = 0; col < w && x + col < 128; col++) {
+      if (x + col >= 0 && (bitmap[(row - y) * rowBytes + col / 8] & (1 << (col % 8)))) {
+        pageBuffer[x + col] |= 1 << (row - top);
+      }
+    }
+  }
+}
+
+void u8x8_DrawTile(u8x8_t *, uint8_t x, uint8_t y, uint8_t count, uint8_t *tiles) {
+  Board::get().displayTiles(x, y, count, tiles);
+}
@@ -0,0 +1,171 @@
+/*
+ * Simulated BME280 for the host build.
+*/
+
+#include "Bme280Model.h"
+#include <math.h>
+#include <string.h>
+
+namespace host {
+
+    Bme280Model::Bme280Model() : Bme280Model(Calibration()) {
+    }
+
+    Bme280Model::Bme280Model(const Calibration &calibration) : cal(calibration) {
+      powerOn();
+    }
+
+    void Bme280Model::powerOn() {
+      memset(regs, 0, sizeof(regs));
+      regs[0xD0] = CHIP_ID;
+
+      regs[0x88] = cal.T1 & 0xFF;
+      regs[0x89] = cal.T1 >> 8;
+      regs[0x8A] = (uint16_t) cal.T2 & 0xFF;
+      regs[0x8B] = (uint16_t) cal.T2 >> 8;
+      regs[0x8C] = (uint16_t) cal.T3 & 0xFF;
+      regs[0x8D] = (uint16_t) cal.T3 >> 8;
+      regs[0xA1] = cal.H1;
+      regs[0xE1] = (uint16_t) cal.H2 & 0xFF;
+      regs[0xE2] = (uint16_t) cal.H2 >> 8;
+      regs[0xE3] = cal.H3;
+      regs[0xE4] = (uint8_t) (cal.H4 >> 4);
+      regs[0xE5] = (uint8_t) ((cal.H4 & 0x0F) | ((cal.H5 & 0x0F) << 4));
+      regs[0xE6] = (uint8_t) (cal.H5 >> 4);
+      regs[0xE7] = (uint8_t) cal.H6;
+
+      // data registers read as "skipped" until the first conversion finishes
+      regs[0xF7] = 0x80;
+      regs[0xFA] = 0x80;
+      regs[0xFD] = 0x80;
+
+      pointer = 0;
+      conversionStart = conversionEnd = 0;
+      filterPrimed = false;
+    }
+
+    void Bme280Model::setEnvironment(double temperature, double relativeHumidity) {
+      temperatureC = temperature;
+      humidity = relativeHumidity;
+    }
+
+    void Bme280Model::setNoise(const Noise &rms, uint64_t seed) {
+      noise = rms;
+      rng.seed(seed);
+    }
+
+    void Bme280Model::write(const uint8_t *data, uint8_t length, uint64_t nowUs) {
+      if (length == 0) return;
+      latchResults(nowUs);
+      pointer = data[0];
+      // anything after the pointer is register/value pairs
+      for (uint8_t i = 1; i < length; i += 2) {
+        uint8_t reg = data[i - 1];
+        uint8_t value = data[i];
+        if (reg == 0xE0 && value == 0xB6) {
+          powerOn(); // soft reset
+          continue;
+        }
+        regs[reg] = value;
+        if (reg == 0xF4 && (value & 0x03) != 0) startConversion(nowUs);
+      }
+    }
+
+    void Bme280Model::read(uint8_t *data, uint8_t length, uint64_t nowUs) {
+      latchResults(nowUs);
+      bool measuring = nowUs < conversionEnd;
+      for (uint8_t i = 0; i < length; i++) {
+        uint8_t reg = pointer + i;
+        data[i] = (reg == 0xF3) ? (measuring ? 0x08 : 0x00) : regs[reg];
+      }
+    }
+
+    uint64_t Bme280Model::measuringOverlap(uint64_t fromUs, uint64_t toUs) const {
+      uint64_t start = conversionStart > fromUs ? conversionStart : fromUs;
+      uint64_t end = conversionEnd < toUs ? conversionEnd : toUs;
+      return end > start ? end - start : 0;
+    }
+
+    uint32_t Bme280Model::conversionTimeUs() const {
+      static const uint8_t samples[8] = {0, 1, 2, 4, 8, 16, 16, 16};
+      uint8_t osrsT = samples[(regs[0xF4] >> 5) & 0x07];
+      uint8_t osrsP = samples[(regs[0xF4] >> 2) & 0x07];
+      uint8_t osrsH = samples[regs[0xF2] & 0x07];
+      uint32_t us = 1250 + 2300 * osrsT;
+      if (osrsP) us += 2300 * osrsP + 575;
+      if (osrsH) us += 2300 * osrsH + 575;
+      return us;
+    }
+
+    void Bme280Model::startConversion(uint64_t nowUs) {
+      conversionStart = nowUs;
+      conversionEnd = nowUs + conversionTimeUs();
+
+      // oversampling averages the noise of its samples, the IIR filter then smooths temperature across conversions
+      static const uint8_t samples[8] = {1, 1, 2, 4, 8, 16, 16, 16};
+      static const uint8_t coefficients[8] = {1, 2, 4, 8, 16, 16, 16, 16};
+      std::normal_distribution<double> gauss(0.0, 1.0);
+      double temperature = temperatureC;
+      double relativeHumidity = humidity;
+      if (noise.temperatureC > 0) {
+        temperature += gauss(rng) * noise.temperatureC / sqrt(samples[(regs[0xF4] >> 5) & 0x07]);
+      }
+      if (noise.humidity > 0) {
+        relativeHumidity += gauss(rng) * noise.humidity / sqrt(samples[regs[0xF2] & 0x07]);
+      }
+      uint8_t coefficient = coefficients[(regs[0xF5] >> 2) & 0x07];
+      filteredC = filterPrimed ? filteredC + (temperature - filteredC) / coefficient : temperature;
+      filterPrimed = true;
+      temperature = filteredC;
+
+      // invert the compensation: both outputs increase monotonically with their ADC input
+      int32_t target = (int32_t) (temperature * 100.0 + (temperature < 0 ? -0.5 : 0.5));
+      int32_t lo = 0, hi = (1 << 20) - 1, tFine = 0;
+      while (lo < hi) {
+        int32_t mid = (lo + hi) / 2;
+        if (compensateTemperature(cal, mid, tFine) < target) lo = mid + 1; else hi = mid;
+      }
+      pendingAdcT = lo;
+      compensateTemperature(cal, pendingAdcT, tFine);
+
+      uint32_t targetH = (uint32_t) (fmin(fmax(relativeHumidity, 0.0), 100.0) * 1024.0 + 0.5);
+      lo = 0;
+      hi = 0xFFFF - 1; // 0x8000 is the "skipped" marker but is a valid reading in the middle of the range
+      while (lo < hi) {
+        int32_t mid = (lo + hi) / 2;
+        if (compensateHumidity(cal, mid, tFine) < targetH) lo = mid + 1; else hi = mid;
+      }
+      pendingAdcH = lo;
+    }
+
+    void Bme280Model::latchResults(uint64_t nowUs) {
+      if (conversionEnd == 0 || nowUs < conversionEnd) return;
+      regs[0xFA] = (uint8_t) (pendingAdcT >> 12);
+      regs[0xFB] = (uint8_t) (pendingAdcT >> 4);
+      regs[0xFC] = (uint8_t) ((pendingAdcT & 0x0F) << 4);
+      regs[0xFD] = (uint8_t) (pendingAdcH >> 8);
+      regs[0xFE] = (uint8_t) pendingAdcH;
+      regs[0xF4] &= ~0x03; // forced mode returns to sleep
+      conversionEnd = 0;
+    }
+
+    int32_t Bme280Model::compensateTemperature(const Calibration &c, int32_t adcT, int32_t &tFine) {
+      int32_t var1 = ((((adcT >> 3) - ((int32_t) c.T1 << 1))) * ((int32_t) c.T2)) >> 11;
+      int32_t var2 = (((((adcT >> 4) - ((int32_t) c.T1)) * ((adcT >> 4) - ((int32_t) c.T1))) >> 12) *
+                      ((int32_t) c.T3)) >> 14;
+      tFine = var1 + var2;
+      return (tFine * 5 + 128) >> 8;
+    }
+
+    uint32_t Bme280Model::compensateHumidity(const Calibration &c, int32_t adcH, int32_t tFine) {
+      int32_t v = tFine - 76800;
+      v = (((((adcH << 14) - (((int32_t) c.H4) << 20) - (((int32_t) c.H5) * v)) + 16384) >> 15) *
+           (((((((v * ((int32_t) c.H6)) >> 10) * (((v * ((int32_t) c.H3)) >> 11) + 32768)) >> 10) + 2097152) *
+             ((int32_t) c.H2) + 8192) >> 14));
+      v = v - (((((v >> 15) * (v >> 15)) >> 7) * ((int32_t) c.H1)) >> 4);
+      v = (v < 0) ? 0 : v;
+      v = (v > 419430400) ? 419430400 : v;
+      return (uint32_t) (v >> 12);
+    }
+
+}
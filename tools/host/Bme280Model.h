@@ -0,0 +1,93 @@
+/*
+ * Simulated BME280 for the host build: register file, forced-mode conversions and factory calibration.
+*/
+
+#ifndef TEMPERATURETRACKER_BME280MODEL_H
+#define TEMPERATURETRACKER_BME280MODEL_H
+
+#include <stdint.h>
+#include <random>
+
+namespace host {
+
+    /**
+     * Register-level BME280 model. Readings come from the temperature and humidity set with setEnvironment(),
+     * converted to raw ADC values by inverting the Bosch compensation for this part's calibration.
+     */
+    class Bme280Model {
+    public:
+        /** Typical factory calibration, the worked example values from the Bosch datasheet. */
+        struct Calibration {
+            uint16_t T1 = 27504;
+            int16_t T2 = 26435;
+            int16_t T3 = -1000;
+            uint8_t H1 = 75;
+            int16_t H2 = 362;
+            uint8_t H3 = 0;
+            int16_t H4 = 313;
+            int16_t H5 = 50;
+            int8_t H6 = 30;
+        };
+
+        Bme280Model();
+
+        explicit Bme280Model(const Calibration &calibration);
+
+        /** Back to the power-on state: sleep mode, default config, data registers invalid. */
+        void powerOn();
+
+        void setEnvironment(double temperatureC, double humidity);
+
+        /** RMS noise of one conversion at oversampling ×1, reduced by oversampling and the IIR filter. */
+        struct Noise {
+            double temperatureC = 0;
+            double humidity = 0;
+        };
+
+        /** Add noise to every conversion from now on, 0 (the default) for exact readings. */
+        void setNoise(const Noise &rms, uint64_t seed);
+
+        /** Handle a write transaction: the register pointer followed by any data bytes. */
+        void write(const uint8_t *data, uint8_t length, uint64_t nowUs);
+
+        /** Handle a read transaction starting at the register pointer. */
+        void read(uint8_t *data, uint8_t length, uint64_t nowUs);
+
+        /** Microseconds of the current conversion that fall inside [fromUs, toUs). */
+        uint64_t measuringOverlap(uint64_t fromUs, uint64_t toUs) const;
+
+        /** Datasheet maximum conversion time for the configured oversampling, in microseconds. */
+        uint32_t conversionTimeUs() const;
+
+        /** Reference Bosch compensation, used to invert readings and to check firmware kernels. */
+        static int32_t compensateTemperature(const Calibration &c, int32_t adcT, int32_t &tFine);
+
+        static uint32_t compensateHumidity(const Calibration &c, int32_t adcH, int32_t tFine);
+
+        const Calibration &calibration() const { return cal; }
+
+    private:
+        static constexpr uint8_t CHIP_ID = 0x60;
+
+        Calibration cal;
+        uint8_t regs[256]; // register file, only 0x88..0xFE are meaningful
+        uint8_t pointer = 0; // register address for the next read
+        uint64_t conversionStart = 0;
+        uint64_t conversionEnd = 0;
+        int32_t pendingAdcT = 0x80000;
+        int32_t pendingAdcH = 0x8000;
+        double temperatureC = 20.0;
+        double humidity = 50.0;
+        Noise noise;
+        std::mt19937_64 rng;
+        double filteredC = 0;     // IIR filter state of the temperature path
+        bool filterPrimed = false; // the first conversion after power on loads the filter directly
+
+        void startConversion(uint64_t nowUs);
+
+        void latchResults(uint64_t nowUs);
+    };
+
+}
+
+#endif //TEMPERATURETRACKER_BME280MODEL_H
@@ -0,0 +1,195 @@
+/*
+ * Simulated hardware around the ATtiny1614 for host builds of the firmware.
+*/
+
+#include "HostBoard.h"
+#include <Arduino.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace host {
+
+    Board &Board::get() {
+      static Board board;
+      return board;
+    }
+
+    Board::Board() {
+      memset(eeprom, 0xFF, sizeof(eeprom)); // erased
+      memset(eepromWrites, 0, sizeof(eepromWrites));
+    }
+
+    void Board::powerOn(InputFn inputFn, void *context) {
+      nowUs = 0;
+      memset(outputs, 0, sizeof(outputs));
+      memset(modes, 0, sizeof(modes));
+      inputs = inputFn;
+      inputContext = context;
+      sensor.powerOn();
+      probe.powerOn();
+      displayOn = false;
+      pagesSent = 0;
+      tilesSent = 0;
+      drawCalls = 0;
+      panelOnUs = 0;
+      firstPixelUs = 0;
+      lastSentUs = 0;
+      idleUs = 0;
+      RSTCTRL.RSTFR = 0x01; // power-on reset
+      WDT.CTRLA = 0;
+      NVMCTRL.STATUS = 0;
+    }
+
+    void Board::pass(uint64_t us, double mcuUa) {
+      double seconds = us / 1e6;
+      chargeUas[RAIL_MCU] += mcuUa * seconds;
+      chargeUas[RAIL_DISPLAY] += (displayOn ? power.displayOnUa : power.displaySleepUa) * seconds;
+      double measuring = sensor.measuringOverlap(nowUs, nowUs + us) / 1e6;
+      chargeUas[RAIL_SENSOR] += power.sensorMeasureUa * measuring + power.sensorSleepUa * (seconds - measuring);
+      if (probeAttached) {
+        measuring = probe.measuringOverlap(nowUs, nowUs + us) / 1e6;
+        chargeUas[RAIL_SENSOR] += power.sensorMeasureUa * measuring + power.sensorSleepUa * (seconds - measuring);
+      }
+      nowUs += us;
+    }
+
+    void Board::pinMode(uint8_t pin, uint8_t mode) {
+      // SCL driven low by hand clocks a device that is holding SDA (WireBus::recover())
+      if (pin == PIN_WIRE_SCL && mode == OUTPUT && modes[pin] != OUTPUT && !outputs[pin]) sclFalling();
+      modes[pin % 32] = mode;
+    }
+
+    void Board::digitalWrite(uint8_t pin, uint8_t value) {
+      // The latch is held externally until the firmware has driven it high once, dropping it after that
+      // cuts the power.
+      if (pin == LATCH_PIN && outputs[pin] && !value) throw PowerCut();
+      if (pin == PIN_WIRE_SCL && modes[pin] == OUTPUT && outputs[pin] && !value) sclFalling();
+      outputs[pin % 32] = value;
+    }
+
+    Bme280Model *Board::deviceAt(uint8_t address) {
+      if (address == SENSOR_ADDRESS && sensorAcks) return &sensor;
+      if (address == PROBE_ADDRESS && probeAttached) return &probe;
+      return nullptr;
+    }
+
+    void Board::sclFalling() {
+      if (i2cStuckClocks && i2cStuckClocks != STUCK_FOREVER) i2cStuckClocks--;
+    }
+
+    int Board::digitalRead(uint8_t pin) {
+      if (modes[pin % 32] == OUTPUT) return outputs[pin % 32];
+      if (pin == PIN_WIRE_SDA) return i2cStuckClocks ? LOW : HIGH; // the bus pull-ups
+      if (pin == PIN_WIRE_SCL) return HIGH;
+      if (inputs) {
+        int level = inputs(pin, nowUs, inputContext);
+        if (level >= 0) return level;
+      }
+      return modes[pin % 32] == INPUT_PULLUP ? HIGH : LOW;
+    }
+
+    bool Board::i2cWrite(uint8_t address, const uint8_t *data, uint8_t length) {
+      if (i2cStuckClocks) {
+        advance(power.i2cTimeoutUs);
+        return false;
+      }
+      advance((length + 1) * power.i2cByteUs);
+      Bme280Model *device = deviceAt(address);
+      if (!device) return false;
+      device->write(data, length, nowUs);
+      return true;
+    }
+
+    bool Board::i2cRead(uint8_t address, uint8_t *data, uint8_t length) {
+      if (i2cStuckClocks) {
+        advance(power.i2cTimeoutUs);
+        return false;
+      }
+      advance((length + 1) * power.i2cByteUs);
+      Bme280Model *device = deviceAt(address);
+      if (!device) return false;
+      device->read(data, length, nowUs);
+      return true;
+    }
+
+    void Board::eepromWrite(uint16_t address, uint8_t value) {
+      address %= EEPROM_SIZE;
+      eeprom[address] = value;
+      eepromWrites[address]++;
+      chargeUas[RAIL_EEPROM] += power.eepromWriteUa * power.eepromWriteUs / 1e6;
+      advance(power.eepromWriteUs);
+    }
+
+    void Board::eepromPageWrite(const uint8_t *image) {
+      bool changed = false;
+      for (uint16_t address = 0; address < EEPROM_SIZE; address++) {
+        if (image[address] == eeprom[address]) continue;
+        eeprom[address] = image[address];
+        eepromWrites[address]++;
+        changed = true;
+      }
+      if (!changed) return;
+      chargeUas[RAIL_EEPROM] += power.eepromWriteUa * power.eepromWriteUs / 1e6;
+      advance(power.eepromWriteUs);
+    }
+
+    void Board::displayPage(uint8_t page, const uint8_t *columns) {
+      memcpy(panel[page % 8], columns, 128);
+      pagesSent++;
+      advance((128 + 6) * power.i2cByteUs); // page data plus addressing commands
+      notePixels(columns, 128);
+    }
+
+    void Board::displayTiles(uint8_t x, uint8_t page, uint8_t count, const uint8_t *tiles) {
+      for (uint16_t i = 0; i < count * 8 && x * 8 + i < 128; i++) panel[page % 8][x * 8 + i] = tiles[i];
+      tilesSent += count;
+      advance((count * 8 + 6) * power.i2cByteUs);
+      notePixels(tiles, count * 8);
+    }
+
+    void Board::notePixels(const uint8_t *columns, uint16_t length) {
+      lastSentUs = nowUs;
+      if (firstPixelUs != 0 || !displayOn) return;
+      for (uint16_t i = 0; i < length; i++) {
+        if (columns[i]) {
+          firstPixelUs = nowUs; // lit once the transfer is done
+          return;
+        }
+      }
+    }
+
+    int Board::adcInternalReference() {
+      advance(power.adcConversionUs);
+      if (batteryMillivolts == 0) return 1023;
+      long reading = 1100L * 1023 / batteryMillivolts;
+      return reading > 1023 ? 1023 : (int) reading;
+    }
+
+    void Board::serialWrite(const uint8_t *data, size_t length) {
+      advance(length * 10 * 1000000ULL / serialBaud); // start bit, 8 data bits, stop bit
+      while (serialFd >= 0 && length) {
+        ssize_t written = ::write(serialFd, data, length);
+        if (written <= 0) {
+          if (written < 0 && errno == EINTR) continue;
+          break; // the other end has gone, like an unplugged adapter
+        }
+        data += written;
+        length -= written;
+      }
+    }
+
+    int Board::serialAvailable() {
+      int pending = 0;
+      if (serialFd < 0 || ioctl(serialFd, FIONREAD, &pending) < 0) return 0;
+      return pending;
+    }
+
+    int Board::serialRead() {
+      uint8_t value;
+      if (!serialAvailable() || ::read(serialFd, &value, 1) != 1) return -1;
+      return value;
+    }
+
+}
@@ -0,0 +1,175 @@
+/*
+ * Simulated hardware around the ATtiny1614 for host builds of the firmware.
+*/
+
+#ifndef TEMPERATURETRACKER_HOSTBOARD_H
+#define TEMPERATURETRACKER_HOSTBOARD_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Bme280Model.h"
+
+namespace host {
+
+    /** Thrown when the firmware releases the power latch: the wake is over. */
+    struct PowerCut {
+    };
+
+    /** Consumers that battery charge is attributed to. */
+    enum Rail : uint8_t {
+        RAIL_MCU,
+        RAIL_DISPLAY,
+        RAIL_SENSOR,
+        RAIL_EEPROM,
+        RAIL_COUNT
+    };
+
+    /**
+     * Currents (uA) and durations (us) of the simulated parts. Defaults are datasheet typicals at 3 V,
+     * not bench measurements, so treat results as relative unless these are calibrated against a unit.
+     */
+    struct PowerModel {
+        double mcuActiveUa = 2500;     // ATtiny1614 active, busy waiting most of the time
+        double mcuIdleUa = 150;        // idle sleep at CLK_PER / 64 with the RTC running (Clock::idle)
+        double displayOnUa = 8000;     // SSD1306 with charge pump, roughly a third of the pixels lit
+        double displaySleepUa = 5;     // SSD1306 after setPowerSave(1) or before begin()
+        double sensorSleepUa = 0.1;    // BME280 sleep mode
+        double sensorMeasureUa = 500;  // BME280 during a forced conversion (T, P and H phases averaged)
+        double eepromWriteUa = 1500;   // extra current of an NVM erase/write
+        uint32_t eepromWriteUs = 4000; // EEPROM erase + write of one page buffer
+        uint32_t i2cByteUs = 25;       // one byte plus ACK at 400 kHz
+        uint32_t i2cTimeoutUs = 200;   // a transaction on a held bus, until the TWI bus timeout gives up
+        uint32_t drawCallUs = 20;      // CPU time of one U8g2 draw primitive on one page
+        uint32_t adcConversionUs = 100; // one ADC conversion including the reference settling
+    };
+
+    /**
+     * The board: virtual clock, GPIO, I2C bus with the BME280 (and optionally the probe), EEPROM and the SSD1306 panel.
+     * There is one board per process. Run devices in parallel with processes, not threads, because the
+     * firmware itself keeps state in statics.
+     */
+    class Board {
+    public:
+        static constexpr uint8_t LATCH_PIN = 2;        // MainController::POWER_CONTROL_PIN
+        static constexpr uint16_t EEPROM_SIZE = 256;
+        static constexpr uint8_t SENSOR_ADDRESS = 0x76;
+        static constexpr uint8_t PROBE_ADDRESS = 0x77;   // the optional second BME280
+
+        /** Level of an input pin driven from outside (button, measurement pulse, EEPROM reset jumper). */
+        typedef int (*InputFn)(uint8_t pin, uint64_t nowUs, void *context);
+
+        static Board &get();
+
+        /** Start a wake: the clock restarts at 0 and every part is in its power-on state. */
+        void powerOn(InputFn inputs, void *context);
+
+        /** Microseconds since powerOn(). */
+        uint64_t now() const { return nowUs; }
+
+        /** Let time pass and charge the battery for it. */
+        void advance(uint64_t us) { pass(us, power.mcuActiveUa); }
+
+        /** Let time pass with the MCU in Clock::idle(). */
+        void idle(uint64_t us) {
+          idleUs += us;
+          pass(us, power.mcuIdleUa);
+        }
+
+        void pinMode(uint8_t pin, uint8_t mode);
+
+        void digitalWrite(uint8_t pin, uint8_t value);
+
+        int digitalRead(uint8_t pin);
+
+        /** I2C transactions, returning false if no device acknowledges the address or SDA is held low. */
+        bool i2cWrite(uint8_t address, const uint8_t *data, uint8_t length);
+
+        bool i2cRead(uint8_t address, uint8_t *data, uint8_t length);
+
+        uint8_t eepromRead(uint16_t address) const { return eeprom[address % EEPROM_SIZE]; }
+
+        void eepromWrite(uint16_t address, uint8_t value);
+
+        /** NVM page erase/write: every byte of `image` that differs from the EEPROM, in one write time. */
+        void eepromPageWrite(const uint8_t *image);
+
+        void displayPower(bool on) {
+          if (on && !displayOn && panelOnUs == 0) panelOnUs = nowUs;
+          displayOn = on;
+        }
+
+        /** Send one 8-row page of 128 columns to the panel. */
+        void displayPage(uint8_t page, const uint8_t *columns);
+
+        /** Send `count` 8x8 tiles starting at tile column x of a page, as u8x8_DrawTile does. */
+        void displayTiles(uint8_t x, uint8_t page, uint8_t count, const uint8_t *tiles);
+
+        /** Account for the CPU time of one draw primitive. */
+        void drawCall() {
+          drawCalls++;
+          advance(power.drawCallUs);
+        }
+
+        /** ADC reading of the 1.1 V reference against VDD, as Battery::readMillivolts() takes it. */
+        int adcInternalReference();
+
+        /** UART, connected to serialFd. Writes take the time the bytes need on the wire. */
+        void serialBegin(uint32_t baud) { serialBaud = baud; }
+
+        void serialWrite(const uint8_t *data, size_t length);
+
+        int serialAvailable();
+
+        int serialRead();
+
+        PowerModel power;
+        Bme280Model sensor;
+        Bme280Model probe;                    // answers only while probeAttached
+        bool probeAttached = false;           // persists across wakes
+
+        uint8_t eeprom[EEPROM_SIZE];          // persists across wakes
+        uint32_t eepromWrites[EEPROM_SIZE];   // physical writes per cell, for wear
+        double chargeUas[RAIL_COUNT] = {};    // charge drawn per rail in uA*s, persists across wakes
+
+        uint8_t panel[8][128] = {};           // SSD1306 display RAM
+        bool displayOn = false;
+        uint32_t pagesSent = 0;               // pages sent since powerOn()
+        uint32_t tilesSent = 0;               // tiles sent since powerOn() outside of whole pages
+        uint32_t drawCalls = 0;               // draw primitives since powerOn()
+        uint64_t panelOnUs = 0;               // when the panel was first switched on since powerOn(), 0 if not yet
+        uint64_t firstPixelUs = 0;            // when the panel first lit a pixel since powerOn(), 0 if not yet
+        uint64_t lastSentUs = 0;              // when the last page or tiles were sent, 0 if none since powerOn()
+        uint64_t idleUs = 0;                  // time spent in Clock::idle() since powerOn()
+
+        uint16_t batteryMillivolts = 3000;    // supply voltage the ADC sees
+
+        // I2C faults, they persist across wakes until cleared
+        bool sensorAcks = true;               // false: the BME280 does not answer (unplugged or dead)
+        uint8_t i2cStuckClocks = 0;           // SCL clocks until a device holding SDA low lets go, 0: bus free
+        static constexpr uint8_t STUCK_FOREVER = 255; // i2cStuckClocks of a device that never lets go
+
+        int serialFd = -1;                    // where the UART is connected, -1 for nowhere
+        bool wallClockDelays = false;         // delay() also sleeps, for talking to another process in real time
+
+    private:
+        Board();
+
+        void pass(uint64_t us, double mcuUa);
+
+        void sclFalling();
+
+        void notePixels(const uint8_t *columns, uint16_t length);
+
+        Bme280Model *deviceAt(uint8_t address);
+
+        uint64_t nowUs = 0;
+        uint32_t serialBaud = 115200;
+        uint8_t outputs[32] = {};
+        uint8_t modes[32] = {};
+        InputFn inputs = nullptr;
+        void *inputContext = nullptr;
+    };
+
+}
+
+#endif //TEMPERATURETRACKER_HOSTBOARD_H
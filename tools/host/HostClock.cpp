@@ -0,0 +1,15 @@
+/*
+ * Host Clock: idle time passes on the board at the slow clock current instead of the active one, and the RTC count
+ * follows the board's clock.
+*/
+
+#include "Clock/Clock.h"
+#include "HostBoard.h"
+
+void Clock::idle(uint16_t ms) {
+  host::Board::get().idle((uint64_t) ms * 1000);
+}
+
+uint16_t Clock::ticks() {
+  return (uint16_t) (host::Board::get().now() * TICKS_PER_SECOND / 1000000);
+}
@@ -0,0 +1,19 @@
+/*
+ * Host CycleTimer: counts the instructions the host CPU executes instead of cycles. The process is single stepped
+ * by a tracer (tools/bench_host) from begin() to end(), and each now() stops at a marker where the tracer writes
+ * its count so far into hostInstructions.
+*/
+
+#include <signal.h>
+#include "Timing/CycleTimer.h"
+
+volatile uint64_t hostInstructions = 0; // a whole word, which is what PTRACE_POKEDATA writes
+
+void CycleTimer::begin() { raise(SIGUSR1); }
+
+void CycleTimer::end() { raise(SIGUSR2); }
+
+uint32_t CycleTimer::now() {
+  raise(SIGUSR1);
+  return (uint32_t) hostInstructions;
+}
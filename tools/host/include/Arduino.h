@@ -0,0 +1,60 @@
+/*
+ * Host stand-in for the Arduino core (megaTinyCore) so the firmware can be compiled and run on a PC.
+ * Only what the firmware uses is provided. Time, pins and peripherals are simulated by host::Board.
+*/
+
+#ifndef TEMPERATURETRACKER_HOST_ARDUINO_H
+#define TEMPERATURETRACKER_HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#ifndef F_CPU
+#define F_CPU 20000000UL
+#endif
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW 0
+
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+// ATtiny1614 pin numbers of the TWI pins (PB1/PB0)
+#define PIN_WIRE_SDA 8
+#define PIN_WIRE_SCL 9
+
+// megaTinyCore analog reference and channel names
+#define VDD 0x10
+#define ADC_INTREF 0x9D
+
+void pinMode(uint8_t pin, uint8_t mode);
+
+void digitalWrite(uint8_t pin, uint8_t value);
+
+int digitalRead(uint8_t pin);
+
+unsigned long millis();
+
+unsigned long micros();
+
+void analogReference(uint8_t mode);
+
+int analogRead(uint8_t pin);
+
+void delay(unsigned long ms);
+
+void delayMicroseconds(unsigned int us);
+
+#include <HardwareSerial.h>
+
+#define F(text) (reinterpret_cast<const __FlashStringHelper *>(text))
+
+#endif //TEMPERATURETRACKER_HOST_ARDUINO_H
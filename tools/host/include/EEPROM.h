@@ -0,0 +1,37 @@
+/*
+ * Host stand-in for the EEPROM library, backed by the simulated 256-byte EEPROM in host::Board.
+*/
+
+#ifndef TEMPERATURETRACKER_HOST_EEPROM_H
+#define TEMPERATURETRACKER_HOST_EEPROM_H
+
+#include <stdint.h>
+
+class EEPROMClass {
+public:
+    uint8_t read(int address);
+
+    void write(int address, uint8_t value);
+
+    void update(int address, uint8_t value);
+
+    uint16_t length();
+
+    template<typename T>
+    T &get(int address, T &value) {
+      uint8_t *bytes = (uint8_t *) &value;
+      for (unsigned i = 0; i < sizeof(T); i++) bytes[i] = read(address + i);
+      return value;
+    }
+
+    template<typename T>
+    const T &put(int address, const T &value) {
+      const uint8_t *bytes = (const uint8_t *) &value;
+      for (unsigned i = 0; i < sizeof(T); i++) update(address + i, bytes[i]);
+      return value;
+    }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif //TEMPERATURETRACKER_HOST_EEPROM_H
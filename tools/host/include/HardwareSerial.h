@@ -0,0 +1,54 @@
+/*
+ * Host stand-in for the megaTinyCore UART (Serial). Bytes go to the file descriptor attached to host::Board,
+ * or nowhere if none is attached.
+*/
+
+#ifndef TEMPERATURETRACKER_HOST_HARDWARESERIAL_H
+#define TEMPERATURETRACKER_HOST_HARDWARESERIAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+class __FlashStringHelper; // F() strings, plain char strings on the host
+
+class HardwareSerial {
+public:
+    void begin(uint32_t baud);
+
+    void end();
+
+    size_t write(uint8_t value);
+
+    size_t write(const uint8_t *data, size_t length);
+
+    int available();
+
+    int read();
+
+    void flush();
+
+    // Print, as much of it as BenchmarkController uses
+    size_t print(const __FlashStringHelper *text);
+
+    size_t print(const char *text);
+
+    size_t print(char c);
+
+    size_t print(unsigned long value);
+
+    size_t print(unsigned int value) { return print((unsigned long) value); }
+
+    size_t print(int value) { return value < 0 ? print('-') + print((unsigned long) -(long) value) : print((unsigned long) value); }
+
+    size_t println(const __FlashStringHelper *text);
+
+    size_t println(unsigned long value);
+
+    size_t println(unsigned int value) { return println((unsigned long) value); }
+
+    size_t println(int value) { return print(value) + print("\r\n"); }
+};
+
+extern HardwareSerial Serial;
+
+#endif //TEMPERATURETRACKER_HOST_HARDWARESERIAL_H
@@ -0,0 +1,55 @@
+/*
+ * Host stand-in for the parts of U8g2 the firmware uses. Drawing goes to the simulated SSD1306 in host::Board,
+ * which keeps a 128x64 frame buffer and accounts for the I2C traffic of each page or tile write.
+*/
+
+#ifndef TEMPERATURETRACKER_HOST_U8G2LIB_H
+#define TEMPERATURETRACKER_HOST_U8G2LIB_H
+
+#include <stdint.h>
+
+struct u8g2_cb_t {
+};
+
+extern const u8g2_cb_t u8g2_cb_r0;
+
+#define U8G2_R0 (&u8g2_cb_r0)
+#define U8X8_PIN_NONE 255
+
+struct u8x8_t {
+};
+
+/** Write `count` 8x8 tiles (8 column bytes each) starting at tile column x of page y. */
+void u8x8_DrawTile(u8x8_t *u8x8, uint8_t x, uint8_t y, uint8_t count, uint8_t *tiles);
+
+class U8G2_SSD1306_128X64_NONAME_1_HW_I2C {
+public:
+    U8G2_SSD1306_128X64_NONAME_1_HW_I2C(const u8g2_cb_t *rotation, uint8_t reset) {}
+
+    void setI2CAddress(uint8_t address) {}
+
+    bool begin();
+
+    void setPowerSave(uint8_t on);
+
+    void firstPage();
+
+    uint8_t nextPage();
+
+    void drawBox(int x, int y, int w, int h);
+
+    void drawLine(int x0, int y0, int x1, int y1);
+
+    /** Only the transparent bitmap mode (1) is modelled. */
+    void setBitmapMode(uint8_t mode) {}
+
+    void drawXBMP(int x, int y, int w, int h, const uint8_t *bitmap);
+
+    u8x8_t *getU8x8() { return &u8x8; }
+
+private:
+    u8x8_t u8x8;
+    uint8_t page = 0; // page (8 pixel rows) currently being rendered
+};
+
+#endif //TEMPERATURETRACKER_HOST_U8G2LIB_H
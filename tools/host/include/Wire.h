@@ -0,0 +1,43 @@
+/*
+ * Host stand-in for the Wire (TWI) library. Transactions are forwarded to the simulated bus in host::Board.
+*/
+
+#ifndef TEMPERATURETRACKER_HOST_WIRE_H
+#define TEMPERATURETRACKER_HOST_WIRE_H
+
+#include <stdint.h>
+
+class TwoWire {
+public:
+    void begin();
+
+    void end();
+
+    void setClock(uint32_t clock);
+
+    void beginTransmission(uint8_t address);
+
+    size_t write(uint8_t value);
+
+    uint8_t endTransmission(bool sendStop = true);
+
+    uint8_t requestFrom(int address, int quantity, bool sendStop = true);
+
+    int available();
+
+    int read();
+
+private:
+    static constexpr uint8_t BUFFER_SIZE = 32; // same as the megaTinyCore Wire buffer
+
+    uint8_t address = 0;
+    uint8_t txBuffer[BUFFER_SIZE];
+    uint8_t txLength = 0;
+    uint8_t rxBuffer[BUFFER_SIZE];
+    uint8_t rxLength = 0;
+    uint8_t rxIndex = 0;
+};
+
+extern TwoWire Wire;
+
+#endif //TEMPERATURETRACKER_HOST_WIRE_H
@@ -0,0 +1,12 @@
+/*
+ * Host stand-in for <avr/interrupt.h>. There are no interrupts on the host.
+*/
+
+#ifndef TEMPERATURETRACKER_HOST_AVR_INTERRUPT_H
+#define TEMPERATURETRACKER_HOST_AVR_INTERRUPT_H
+
+inline void cli() {}
+
+inline void sei() {}
+
+#endif //TEMPERATURETRACKER_HOST_AVR_INTERRUPT_H
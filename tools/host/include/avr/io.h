@@ -0,0 +1,72 @@
+/*
+ * Host stand-in for the tinyAVR register file, limited to the registers the firmware touches.
+*/
+
+#ifndef TEMPERATURETRACKER_HOST_AVR_IO_H
+#define TEMPERATURETRACKER_HOST_AVR_IO_H
+
+#include <stdint.h>
+
+struct RSTCTRL_t {
+    uint8_t RSTFR;
+};
+
+struct WDT_t {
+    uint8_t CTRLA;
+};
+
+struct NVMCTRL_t {
+    uint8_t CTRLA;
+    uint8_t STATUS;
+};
+
+struct VREF_t {
+    uint8_t CTRLA;
+};
+
+// Status flags are cleared by writing one to them
+struct TwiStatus {
+    uint8_t flags;
+
+    TwiStatus &operator=(uint8_t value) {
+      flags &= ~value;
+      return *this;
+    }
+
+    operator uint8_t() const { return flags; }
+};
+
+struct TWI_t {
+    uint8_t MCTRLA;
+    TwiStatus MSTATUS; // the simulated bus raises no bus errors, a held SDA is seen on the pin
+};
+
+extern RSTCTRL_t RSTCTRL;
+extern WDT_t WDT;
+extern NVMCTRL_t NVMCTRL;
+extern VREF_t VREF;
+extern TWI_t TWI0;
+
+#define RSTCTRL_WDRF_bm 0x08
+#define WDT_PERIOD_8KCLK_gc 0x0B
+#define NVMCTRL_EEBUSY_bm 0x02
+#define NVMCTRL_CMD_PAGEERASEWRITE_gc 0x03
+#define NVMCTRL_CMD_PAGEBUFCLR_gc 0x04
+#define EEPROM_PAGE_SIZE 32
+#define VREF_ADC0REFSEL_gm 0x07
+#define VREF_ADC0REFSEL_1V1_gc 0x01
+#define TWI_TIMEOUT_200US_gc 0x0C
+#define TWI_BUSERR_bm 0x04
+
+#define _PROTECTED_WRITE(reg, value) ((reg) = (value))
+
+// The EEPROM is memory mapped, writes there load the NVM page buffer and NVMCTRL commands act on it
+namespace host {
+    extern uint8_t mappedEeprom[256];
+
+    void nvmCommand(uint8_t command);
+}
+#define MAPPED_EEPROM_START ((uintptr_t) host::mappedEeprom)
+#define _PROTECTED_WRITE_SPM(reg, value) (((reg) = (value)), host::nvmCommand(value))
+
+#endif //TEMPERATURETRACKER_HOST_AVR_IO_H
@@ -0,0 +1,14 @@
+/*
+ * Host stand-in for <avr/pgmspace.h>. Flash and RAM share one address space on the host.
+*/
+
+#ifndef TEMPERATURETRACKER_HOST_AVR_PGMSPACE_H
+#define TEMPERATURETRACKER_HOST_AVR_PGMSPACE_H
+
+#include <stdint.h>
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *) (addr))
+#define pgm_read_word(addr) (*(const uint16_t *) (addr))
+
+#endif //TEMPERATURETRACKER_HOST_AVR_PGMSPACE_H
@@ -0,0 +1,23 @@
+/*
+ * Host stand-in for <avr/sleep.h>. sleep_cpu() never returns on the device once interrupts are off,
+ * so on the host it ends the wake like the latch collapsing does.
+*/
+
+#ifndef TEMPERATURETRACKER_HOST_AVR_SLEEP_H
+#define TEMPERATURETRACKER_HOST_AVR_SLEEP_H
+
+#include <stdint.h>
+
+#define SLEEP_MODE_IDLE 0
+#define SLEEP_MODE_STANDBY 1
+#define SLEEP_MODE_PWR_DOWN 2
+
+inline void set_sleep_mode(uint8_t) {}
+
+inline void sleep_enable() {}
+
+inline void sleep_disable() {}
+
+void sleep_cpu();
+
+#endif //TEMPERATURETRACKER_HOST_AVR_SLEEP_H
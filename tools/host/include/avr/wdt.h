@@ -0,0 +1,10 @@
+/*
+ * Host stand-in for <avr/wdt.h>.
+*/
+
+#ifndef TEMPERATURETRACKER_HOST_AVR_WDT_H
+#define TEMPERATURETRACKER_HOST_AVR_WDT_H
+
+void wdt_reset();
+
+#endif //TEMPERATURETRACKER_HOST_AVR_WDT_H
@@ -0,0 +1,211 @@
+/*
+ * Bulk decoder for Logger EEPROM dumps.
+*/
+
+#include "EepromIngest.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ingest {
+
+    const char *toString(DumpStatus status) {
+      switch (status) {
+        case DumpStatus::OK:
+          return "ok";
+        case DumpStatus::BAD_POINTER:
+          return "bad_pointer";
+        case DumpStatus::ERASED:
+          return "erased";
+        case DumpStatus::TRUNCATED:
+          return "truncated";
+      }
+      return "unknown";
+    }
+
+    void Columns::clear() {
+      dump.clear();
+      sample.clear();
+      temperature.clear();
+      humidity.clear();
+      millivolts.clear();
+      probeTemperature.clear();
+      probeHumidity.clear();
+    }
+
+    /**
+     * A channel's decoded value for every cell code, filled once from LoggerCodec::decodeTemp/decodeHum, so decoding
+     * is one table lookup per cell and can never drift from the firmware's codec.
+     */
+    struct DecodeTable {
+      float value[256];
+
+      DecodeTable(float (*decode)(uint8_t), float empty) {
+        for (int code = 0; code < 256; code++) value[code] = decode((uint8_t) code);
+        value[LoggerCodec::EMPTY] = empty;
+      }
+
+      void apply(const uint8_t *codes, size_t n, float *out) const {
+        for (size_t i = 0; i < n; i++) out[i] = value[codes[i]];
+      }
+    };
+
+    // an EMPTY cell decodes to 0 like in the firmware, except on the probe channels where it means there is no probe
+    static const DecodeTable TEMPERATURES(LoggerCodec::decodeTemp, LoggerCodec::decodeTemp(LoggerCodec::EMPTY));
+    static const DecodeTable HUMIDITIES(LoggerCodec::decodeHum, LoggerCodec::decodeHum(LoggerCodec::EMPTY));
+    static const DecodeTable PROBE_TEMPERATURES(LoggerCodec::decodeTemp, NAN);
+    static const DecodeTable PROBE_HUMIDITIES(LoggerCodec::decodeHum, NAN);
+
+    void Decoder::decodeTemperatures(const uint8_t *codes, size_t n, float *out) { TEMPERATURES.apply(codes, n, out); }
+
+    void Decoder::decodeHumidities(const uint8_t *codes, size_t n, float *out) { HUMIDITIES.apply(codes, n, out); }
+
+    void Decoder::decodeProbe(const uint8_t *codes, size_t n, bool temperature, float *out) {
+      (temperature ? PROBE_TEMPERATURES : PROBE_HUMIDITIES).apply(codes, n, out);
+    }
+
+    void Decoder::decodeImages(const uint8_t *data, size_t count, uint32_t firstDump, Columns &out) {
+      size_t row = out.size();
+      for (size_t i = 0; i < count; i++) {
+        gather(data + i * IMAGE_SIZE, IMAGE_SIZE, firstDump + (uint32_t) i, out);
+      }
+      decodeGathered(row, out);
+    }
+
+    DumpStatus Decoder::decodeImage(const uint8_t *image, size_t size, uint32_t dump, Columns &out) {
+      size_t row = out.size();
+      DumpStatus status = gather(image, size, dump, out);
+      decodeGathered(row, out);
+      return status;
+    }
+
+    /** Append the ring of N cells at `cells` to `to`, rotated so the one at `front` comes first. */
+    static void appendRotated(std::vector<uint8_t> &to, const uint8_t *cells, uint8_t front) {
+      to.insert(to.end(), cells + front, cells + LoggerCodec::NUM_SAMPLES);
+      to.insert(to.end(), cells, cells + front);
+    }
+
+    /** True if the image carries the page record format's marker, otherwise it is format 1 or erased. */
+    static bool pageFormat(const uint8_t *image) {
+      return image[LoggerCodec::FORMAT_ADDR] == LoggerCodec::FORMAT_MAGIC &&
+             image[LoggerCodec::FORMAT_ADDR + 1] == LoggerCodec::FORMAT_VERSION;
+    }
+
+    /** The front pointer of a page record image: the one on the last page written in page 0's lap. */
+    static uint8_t pageFront(const uint8_t *image) {
+      uint8_t lap = image[LoggerCodec::LAP_OFFSET];
+      uint8_t page = 0;
+      while (page + 1 < LoggerCodec::HISTORY_PAGES &&
+             image[(page + 1) * LoggerCodec::PAGE_SIZE + LoggerCodec::LAP_OFFSET] == lap) {
+        page++;
+      }
+      return image[page * LoggerCodec::PAGE_SIZE + LoggerCodec::PTR_OFFSET];
+    }
+
+    DumpStatus Decoder::gather(const uint8_t *image, size_t size, uint32_t dump, Columns &out) {
+      constexpr uint8_t N = LoggerCodec::NUM_SAMPLES;
+      DumpStatus status = DumpStatus::OK;
+      totals.dumps++;
+
+      if (size < IMAGE_SIZE) {
+        status = DumpStatus::TRUNCATED;
+      } else {
+        // each cell of a record as a ring of N by slot: the channels, then the voltage
+        uint8_t cells[LoggerCodec::RECORD_SIZE][N];
+        uint8_t front;
+        bool erased = true;
+        if (pageFormat(image)) {
+          for (uint8_t slot = 0; slot < N; slot++) {
+            const uint8_t *record = image + LoggerCodec::recordAddr(slot);
+            for (uint8_t cell = 0; cell < LoggerCodec::RECORD_SIZE; cell++) {
+              cells[cell][slot] = record[cell];
+              erased &= record[cell] == LoggerCodec::EMPTY;
+            }
+          }
+          front = pageFront(image);
+        } else {
+          using Format1 = LoggerCodec::Format1;
+          // the history sector is sector 0, its rings and the probe's are contiguous
+          for (uint8_t i = 0; i < Format1::SECTOR_SIZE; i++) erased &= image[i] == 0xFF;
+          memcpy(cells[LoggerCodec::TEMPERATURE], image + Format1::TEMP_ADDR, N);
+          memcpy(cells[LoggerCodec::HUMIDITY], image + Format1::HUM_ADDR, N);
+          memcpy(cells[LoggerCodec::PROBE_TEMPERATURE], image + Format1::PROBE_TEMP_ADDR, N);
+          memcpy(cells[LoggerCodec::PROBE_HUMIDITY], image + Format1::PROBE_HUM_ADDR, N);
+          memcpy(cells[LoggerCodec::VOLTAGE_CELL], image + Format1::VOLTAGE_ADDR, N);
+          front = image[Format1::PTR_ADDR];
+        }
+
+        if (erased) {
+          status = DumpStatus::ERASED;
+        } else {
+          if (front >= N) {
+            status = DumpStatus::BAD_POINTER;
+            front = 0; // same recovery as Logger
+          }
+
+          // rotate into oldest → newest order
+          for (uint8_t channel = 0; channel < 4; channel++) appendRotated(codes[channel], cells[channel], front);
+
+          const uint8_t *voltages = cells[LoggerCodec::VOLTAGE_CELL];
+          for (uint8_t i = 0; i < N; i++) {
+            out.dump.push_back(dump);
+            out.sample.push_back(i);
+            out.millivolts.push_back(LoggerCodec::decodeVoltage(voltages[(front + i) % N]));
+          }
+        }
+      }
+
+      totals.status[(int) status]++;
+      return status;
+    }
+
+    void Decoder::decodeGathered(size_t row, Columns &out) {
+      size_t n = out.size() - row;
+      out.temperature.resize(row + n);
+      out.humidity.resize(row + n);
+      out.probeTemperature.resize(row + n);
+      out.probeHumidity.resize(row + n);
+      if (n) {
+        decodeTemperatures(codes[0].data(), n, &out.temperature[row]);
+        decodeHumidities(codes[1].data(), n, &out.humidity[row]);
+        decodeProbe(codes[2].data(), n, true, &out.probeTemperature[row]);
+        decodeProbe(codes[3].data(), n, false, &out.probeHumidity[row]);
+      }
+      for (std::vector<uint8_t> &channel : codes) channel.clear();
+    }
+
+    MappedFile::MappedFile(const std::string &path) {
+      int fd = open(path.c_str(), O_RDONLY);
+      if (fd < 0) {
+        error = strerror(errno);
+        return;
+      }
+      struct stat info;
+      if (fstat(fd, &info) != 0) {
+        error = strerror(errno);
+        close(fd);
+        return;
+      }
+      length = (size_t) info.st_size;
+      if (length > 0) {
+        void *mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+          error = strerror(errno);
+          length = 0;
+        } else {
+          bytes = static_cast<const uint8_t *>(mapping);
+          madvise(mapping, length, MADV_SEQUENTIAL);
+        }
+      }
+      close(fd);
+    }
+
+    MappedFile::~MappedFile() {
+      if (bytes) munmap(const_cast<uint8_t *>(bytes), length);
+    }
+
+}
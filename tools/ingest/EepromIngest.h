@@ -0,0 +1,115 @@
+/*
+ * Bulk decoder for Logger EEPROM dumps.
+*/
+
+#ifndef TEMPERATURETRACKER_EEPROMINGEST_H
+#define TEMPERATURETRACKER_EEPROMINGEST_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "Logger/LoggerCodec.h"
+
+namespace ingest {
+
+    /** Result of validating one dump. */
+    enum class DumpStatus : uint8_t {
+        OK,
+        BAD_POINTER, // front pointer out of range, decoded from 0 like Logger does
+        ERASED,      // history never written
+        TRUNCATED,   // fewer bytes than a full EEPROM image
+    };
+
+    const char *toString(DumpStatus status);
+
+    /**
+     * Decoded samples in columnar form, one row per sample, oldest → newest within each dump.
+     */
+    struct Columns {
+        std::vector<uint32_t> dump;         // index of the dump the sample came from
+        std::vector<uint8_t> sample;        // 0 = oldest .. NUM_SAMPLES - 1 = newest
+        std::vector<float> temperature;
+        std::vector<float> humidity;
+        std::vector<uint16_t> millivolts;   // battery voltage, 0 where none was logged
+        std::vector<float> probeTemperature; // external probe, NAN where it was not attached
+        std::vector<float> probeHumidity;
+
+        size_t size() const { return dump.size(); }
+
+        void clear();
+    };
+
+    /** Running totals of everything decoded so far. */
+    struct Stats {
+        uint64_t dumps = 0;
+        uint64_t status[4] = {}; // indexed by DumpStatus
+    };
+
+    /**
+     * Decodes 256-byte EEPROM images, on their own or concatenated back to back, into Columns.
+     * Layout and scaling come from LoggerCodec, the same definitions the firmware Logger uses. Images in the page
+     * record format and format 1 ones (units not yet updated) are both read.
+     */
+    class Decoder {
+    public:
+        static constexpr size_t IMAGE_SIZE = LoggerCodec::EEPROM_SIZE;
+
+        /**
+         * Decode `count` consecutive images starting at `data`, numbering them from firstDump. The images are
+         * validated and their cells gathered first, then each channel is decoded for all of them in one pass.
+         */
+        void decodeImages(const uint8_t *data, size_t count, uint32_t firstDump, Columns &out);
+
+        /** Validate and decode a single image of `size` bytes. ERASED and TRUNCATED dumps add no rows. */
+        DumpStatus decodeImage(const uint8_t *image, size_t size, uint32_t dump, Columns &out);
+
+        /** Decode a block of encoded cells, one lookup each in a table built from LoggerCodec. */
+        static void decodeTemperatures(const uint8_t *codes, size_t n, float *out);
+
+        static void decodeHumidities(const uint8_t *codes, size_t n, float *out);
+
+        /** The probe channels, where an EMPTY cell means no probe rather than 0. */
+        static void decodeProbe(const uint8_t *codes, size_t n, bool temperature, float *out);
+
+        const Stats &stats() const { return totals; }
+
+    private:
+        /** Validate one image and append its rows, with the encoded cells gathered into `codes` oldest → newest. */
+        DumpStatus gather(const uint8_t *image, size_t size, uint32_t dump, Columns &out);
+
+        /** Decode the gathered cells into the rows from `row` on and empty the gather buffers. */
+        void decodeGathered(size_t row, Columns &out);
+
+        Stats totals;
+        std::vector<uint8_t> codes[4]; // temperature, humidity, probe temperature, probe humidity
+    };
+
+    /** A read-only memory mapping of a whole file. */
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string &path);
+
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        bool ok() const { return error.empty(); }
+
+        const std::string &errorMessage() const { return error; }
+
+        const uint8_t *data() const { return bytes; }
+
+        size_t size() const { return length; }
+
+    private:
+        const uint8_t *bytes = nullptr;
+        size_t length = 0;
+        std::string error;
+    };
+
+}
+
+#endif //TEMPERATURETRACKER_EEPROMINGEST_H
@@ -0,0 +1,248 @@
+/*
+ * eeprom_ingest: decode bulk Logger EEPROM dumps into columnar output.
+ *
+ * Every input file holds one or more raw 256-byte EEPROM images back to back (as read with
+ * `avrdude ... -U eeprom:r:file.bin:r`, or many such reads concatenated). Files are memory mapped and decoded in
+ * batches, so throughput is bounded by the output format rather than the decoding.
+*/
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "EepromIngest.h"
+
+namespace {
+
+    constexpr size_t BATCH_IMAGES = 4096; // images decoded before the columns are flushed
+
+    /**
+     * Writes rows as CSV: dump,sample,temperature,humidity,millivolts,probe_temperature,probe_humidity (the last three
+     * empty where none was logged).
+     */
+    class CsvWriter {
+    public:
+        explicit CsvWriter(FILE *out) : out(out) {
+          fputs("dump,sample,temperature,humidity,millivolts,probe_temperature,probe_humidity\n", out);
+        }
+
+        void write(const ingest::Columns &columns) {
+          std::string buffer;
+          buffer.reserve(columns.size() * 36);
+          char line[64];
+          for (size_t i = 0; i < columns.size(); i++) {
+            char *p = line;
+            p = appendUnsigned(p, columns.dump[i]);
+            *p++ = ',';
+            p = appendUnsigned(p, columns.sample[i]);
+            *p++ = ',';
+            p = appendCentis(p, columns.temperature[i]);
+            *p++ = ',';
+            p = appendCentis(p, columns.humidity[i]);
+            *p++ = ',';
+            if (columns.millivolts[i]) p = appendUnsigned(p, columns.millivolts[i]);
+            *p++ = ',';
+            if (!std::isnan(columns.probeTemperature[i])) p = appendCentis(p, columns.probeTemperature[i]);
+            *p++ = ',';
+            if (!std::isnan(columns.probeHumidity[i])) p = appendCentis(p, columns.probeHumidity[i]);
+            *p++ = '\n';
+            buffer.append(line, p - line);
+          }
+          fwrite(buffer.data(), 1, buffer.size(), out);
+        }
+
+    private:
+        FILE *out;
+
+        static char *appendUnsigned(char *p, uint32_t value) {
+          char digits[10];
+          int n = 0;
+          do {
+            digits[n++] = (char) ('0' + value % 10);
+            value /= 10;
+          } while (value);
+          while (n) *p++ = digits[--n];
+          return p;
+        }
+
+        /** Fixed two decimals, which is finer than the 0.43 degree / 0.39 % step of the encoding. */
+        static char *appendCentis(char *p, float value) {
+          long centis = lroundf(value * 100.0f);
+          if (centis < 0) {
+            *p++ = '-';
+            centis = -centis;
+          }
+          p = appendUnsigned(p, (uint32_t) (centis / 100));
+          *p++ = '.';
+          *p++ = (char) ('0' + (centis / 10) % 10);
+          *p++ = (char) ('0' + centis % 10);
+          return p;
+        }
+    };
+
+    /** Writes each column as a raw little-endian array in its own file. */
+    class ColumnWriter {
+    public:
+        explicit ColumnWriter(const std::string &dir) {
+          files[0] = open(dir + "/dump.u32");
+          files[1] = open(dir + "/sample.u8");
+          files[2] = open(dir + "/temperature.f32");
+          files[3] = open(dir + "/humidity.f32");
+          files[4] = open(dir + "/millivolts.u16");
+          files[5] = open(dir + "/probe_temperature.f32");
+          files[6] = open(dir + "/probe_humidity.f32");
+        }
+
+        ~ColumnWriter() {
+          for (FILE *f : files) fclose(f);
+        }
+
+        void write(const ingest::Columns &columns) {
+          fwrite(columns.dump.data(), sizeof(uint32_t), columns.size(), files[0]);
+          fwrite(columns.sample.data(), sizeof(uint8_t), columns.size(), files[1]);
+          fwrite(columns.temperature.data(), sizeof(float), columns.size(), files[2]);
+          fwrite(columns.humidity.data(), sizeof(float), columns.size(), files[3]);
+          fwrite(columns.millivolts.data(), sizeof(uint16_t), columns.size(), files[4]);
+          fwrite(columns.probeTemperature.data(), sizeof(float), columns.size(), files[5]);
+          fwrite(columns.probeHumidity.data(), sizeof(float), columns.size(), files[6]);
+        }
+
+    private:
+        FILE *files[7];
+
+        static FILE *open(const std::string &path) {
+          FILE *f = fopen(path.c_str(), "wb");
+          if (!f) {
+            perror(path.c_str());
+            exit(1);
+          }
+          return f;
+        }
+    };
+
+    void usage(const char *argv0) {
+      fprintf(stderr,
+              "usage: %s [--csv FILE | --columns DIR | --validate] [--manifest FILE] dump...\n"
+              "  --csv FILE       write rows as CSV (default: stdout)\n"
+              "  --columns DIR    write dump.u32, sample.u8, temperature.f32, humidity.f32, millivolts.u16,\n"
+              "                   probe_temperature.f32 and probe_humidity.f32 into DIR\n"
+              "  --validate       only decode and report\n"
+              "  --manifest FILE  write dump,file,offset,status for every dump\n", argv0);
+      exit(2);
+    }
+
+}
+
+int main(int argc, char **argv) {
+  const char *csvPath = nullptr;
+  const char *columnsDir = nullptr;
+  const char *manifestPath = nullptr;
+  bool validateOnly = false;
+  std::vector<std::string> inputs;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--csv" && i + 1 < argc) csvPath = argv[++i];
+    else if (arg == "--columns" && i + 1 < argc) columnsDir = argv[++i];
+    else if (arg == "--manifest" && i + 1 < argc) manifestPath = argv[++i];
+    else if (arg == "--validate") validateOnly = true;
+    else if (!arg.empty() && arg[0] == '-') usage(argv[0]);
+    else inputs.push_back(arg);
+  }
+  if (inputs.empty() || (csvPath && columnsDir)) usage(argv[0]);
+
+  CsvWriter *csv = nullptr;
+  ColumnWriter *columnWriter = nullptr;
+  FILE *csvFile = nullptr;
+  if (columnsDir) {
+    columnWriter = new ColumnWriter(columnsDir);
+  } else if (!validateOnly) {
+    csvFile = csvPath ? fopen(csvPath, "w") : stdout;
+    if (!csvFile) {
+      perror(csvPath);
+      return 1;
+    }
+    csv = new CsvWriter(csvFile);
+  }
+  FILE *manifest = nullptr;
+  if (manifestPath) {
+    manifest = fopen(manifestPath, "w");
+    if (!manifest) {
+      perror(manifestPath);
+      return 1;
+    }
+    fputs("dump,file,offset,status\n", manifest);
+  }
+
+  ingest::Decoder decoder;
+  ingest::Columns columns;
+  uint32_t nextDump = 0;
+  int status = 0;
+  uint64_t bytes = 0;
+  auto flush = [&]() {
+    if (csv) csv->write(columns);
+    if (columnWriter) columnWriter->write(columns);
+    columns.clear();
+  };
+
+  auto started = std::chrono::steady_clock::now();
+  for (const std::string &path : inputs) {
+    ingest::MappedFile file(path);
+    if (!file.ok()) {
+      fprintf(stderr, "%s: %s\n", path.c_str(), file.errorMessage().c_str());
+      status = 1;
+      continue;
+    }
+    bytes += file.size();
+    size_t images = file.size() / ingest::Decoder::IMAGE_SIZE;
+    size_t tail = file.size() % ingest::Decoder::IMAGE_SIZE;
+
+    for (size_t first = 0; first < images; first += BATCH_IMAGES) {
+      size_t count = std::min(BATCH_IMAGES, images - first);
+      const uint8_t *data = file.data() + first * ingest::Decoder::IMAGE_SIZE;
+      if (manifest) {
+        for (size_t i = 0; i < count; i++) {
+          ingest::DumpStatus result = decoder.decodeImage(data + i * ingest::Decoder::IMAGE_SIZE,
+                                                          ingest::Decoder::IMAGE_SIZE, nextDump, columns);
+          fprintf(manifest, "%u,%s,%zu,%s\n", nextDump++, path.c_str(),
+                  (first + i) * ingest::Decoder::IMAGE_SIZE, ingest::toString(result));
+        }
+      } else {
+        decoder.decodeImages(data, count, nextDump, columns);
+        nextDump += (uint32_t) count;
+      }
+      flush();
+    }
+    if (tail || images == 0) {
+      ingest::DumpStatus result = decoder.decodeImage(file.data() + images * ingest::Decoder::IMAGE_SIZE, tail,
+                                                      nextDump, columns);
+      if (manifest) {
+        fprintf(manifest, "%u,%s,%zu,%s\n", nextDump, path.c_str(), images * ingest::Decoder::IMAGE_SIZE,
+                ingest::toString(result));
+      }
+      nextDump++;
+    }
+  }
+  flush();
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+  delete csv;
+  delete columnWriter;
+  if (csvFile && csvFile != stdout) fclose(csvFile);
+  if (manifest) fclose(manifest);
+
+  const ingest::Stats &stats = decoder.stats();
+  fprintf(stderr, "%llu dumps (%.1f MB) in %.3f s, %.0f dumps/s:",
+          (unsigned long long) stats.dumps, bytes / 1e6, seconds, seconds > 0 ? stats.dumps / seconds : 0.0);
+  for (int s = 0; s < 4; s++) {
+    fprintf(stderr, " %s %llu", ingest::toString((ingest::DumpStatus) s), (unsigned long long) stats.status[s]);
+  }
+  fprintf(stderr, "\n");
+  if (stats.status[(int) ingest::DumpStatus::BAD_POINTER] || stats.status[(int) ingest::DumpStatus::TRUNCATED]) {
+    status = 1;
+  }
+  return status;
+}
@@ -0,0 +1,204 @@
+/*
+ * sensor_profiles: measurement energy against reading noise for each Sensor::Profile.
+ *
+ * Runs the firmware Sensor on the simulated board with noise added to every BME280 conversion. The noise figures
+ * (RMS at oversampling ×1) are assumptions, so pass ones measured on a unit with --temp-noise / --hum-noise to trust
+ * the absolute numbers. Two cases are reported per profile:
+ *   wake     a measurement wake: power on, setup() and one readData(), which is what the logged chart sees
+ *   session  readData() every 250 ms on one powered sensor, as on the main screen, where the IIR filter settles
+ * Energy is the charge the sensor and the MCU draw for one reading. "chart steps" is how often two readings of an
+ * unchanged environment land in different chart cells (LoggerCodec encoding), averaged over true values spread
+ * across a cell.
+ *
+ * A second table times a measurement wake with the external probe attached: both sensors set up and read together
+ * (Sensor::setupAll / readAll), against one sensor and against the two handled one after the other.
+*/
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "Arduino.h"
+#include "HostBoard.h"
+#include "Sensor/Sensor.h"
+#include "Logger/LoggerCodec.h"
+
+namespace {
+
+    struct Options {
+        int readings = 2000;
+        double temperatureNoise = 0.05; // °C RMS at ×1
+        double humidityNoise = 0.2;     // %RH RMS at ×1
+        uint64_t seed = 1;
+    };
+
+    struct Result {
+        double chargeUas = 0;   // sensor + MCU charge per reading
+        double sensorUas = 0;   // sensor rail alone
+        double ms = 0;          // time per reading
+        double temperatureSd = 0;
+        double humiditySd = 0;
+        double temperatureSteps = 0; // fraction of consecutive readings in different chart cells
+        double humiditySteps = 0;
+    };
+
+    const char *const NAMES[Sensor::PROFILE_COUNT] = {"ultra-low-power", "indoor", "high-precision"};
+
+    int noInputs(uint8_t, uint64_t, void *) { return -1; }
+
+    double railCharge(const host::Board &board) {
+      return board.chargeUas[host::RAIL_SENSOR] + board.chargeUas[host::RAIL_MCU];
+    }
+
+    /** Running mean / variance (Welford) and cell changes between consecutive readings. */
+    struct Series {
+        double n = 0, mean = 0, m2 = 0;
+        uint32_t changes = 0, pairs = 0;
+        int previous = -1;
+
+        void add(double value, int cell) {
+          n++;
+          double delta = value - mean;
+          mean += delta / n;
+          m2 += delta * (value - mean);
+          if (previous >= 0) {
+            pairs++;
+            changes += cell != previous;
+          }
+          previous = cell;
+        }
+
+        void restart() { previous = -1; }
+
+        double sd() const { return n > 1 ? std::sqrt(m2 / (n - 1)) : 0; }
+
+        double stepRate() const { return pairs ? (double) changes / pairs : 0; }
+    };
+
+    Result run(const Options &options, Sensor::Profile profile, bool session) {
+      host::Board &board = host::Board::get();
+      Series temperature, humidity;
+      Result result;
+
+      // true values spread evenly over one chart cell, so the step rate does not depend on where they sit in it
+      constexpr int LEVELS = 16;
+      const double tempCell = (LoggerCodec::MAX_TEMP - LoggerCodec::MIN_TEMP) / 255.0;
+      const double humCell = (LoggerCodec::MAX_HUM - LoggerCodec::MIN_HUM) / 255.0;
+      int perLevel = options.readings / LEVELS;
+
+      for (int level = 0; level < LEVELS; level++) {
+        double trueTemperature = 21.0 + tempCell * level / LEVELS;
+        double trueHumidity = 45.0 + humCell * level / LEVELS;
+        temperature.restart();
+        humidity.restart();
+        Series levelTemperature, levelHumidity;
+
+        board.powerOn(noInputs, nullptr);
+        board.sensor.setNoise({options.temperatureNoise, options.humidityNoise}, options.seed * 977 + level);
+        board.sensor.setEnvironment(trueTemperature, trueHumidity);
+        Sensor sensor;
+        sensor.setProfile(profile);
+        if (session) sensor.setup();
+
+        for (int i = 0; i < perLevel; i++) {
+          if (!session) board.powerOn(noInputs, nullptr); // the sensor loses its filter state with the rail
+          double charge = railCharge(board);
+          double sensorCharge = board.chargeUas[host::RAIL_SENSOR];
+          uint64_t started = board.now();
+          if (!session) sensor.setup();
+          Sensor::Data data = sensor.readData();
+          result.chargeUas += railCharge(board) - charge;
+          result.sensorUas += board.chargeUas[host::RAIL_SENSOR] - sensorCharge;
+          result.ms += (board.now() - started) / 1000.0;
+          if (session) board.advance(250000);
+
+          temperature.add(data.temperature, LoggerCodec::encodeTemp(data.temperature));
+          humidity.add(data.humidity, LoggerCodec::encodeHum(data.humidity));
+          levelTemperature.add(data.temperature, 0);
+          levelHumidity.add(data.humidity, 0);
+        }
+        result.temperatureSd += levelTemperature.sd() / LEVELS;
+        result.humiditySd += levelHumidity.sd() / LEVELS;
+      }
+
+      int total = perLevel * LEVELS;
+      result.chargeUas /= total;
+      result.sensorUas /= total;
+      result.ms /= total;
+      result.temperatureSteps = temperature.stepRate();
+      result.humiditySteps = humidity.stepRate();
+      return result;
+    }
+
+    /** Sensor time of one measurement wake: setup and a reading of `count` sensors, together or one by one. */
+    double pairWakeMs(Sensor::Profile profile, uint8_t count, bool together) {
+      host::Board &board = host::Board::get();
+      board.probeAttached = count > 1;
+      board.powerOn(noInputs, nullptr);
+      Sensor sensor, probe(BME280_ADDR_PROBE);
+      sensor.setProfile(profile);
+      probe.setProfile(profile);
+      Sensor *sensors[] = {&sensor, &probe};
+      Sensor::Data data[2];
+      if (together) {
+        Sensor::setupAll(sensors, count);
+        Sensor::readAll(sensors, data, count);
+      } else {
+        for (uint8_t i = 0; i < count; i++) {
+          sensors[i]->setup();
+          data[i] = sensors[i]->readData();
+        }
+      }
+      board.probeAttached = false;
+      return board.now() / 1000.0;
+    }
+
+    void usage(const char *argv0) {
+      fprintf(stderr,
+              "usage: %s [options]\n"
+              "  --readings N      readings per profile and case (2000)\n"
+              "  --temp-noise C    temperature noise of one conversion at x1, degrees C RMS (0.05)\n"
+              "  --hum-noise H     humidity noise of one conversion at x1, %%RH RMS (0.2)\n"
+              "  --seed S          random seed (1)\n", argv0);
+      exit(2);
+    }
+
+}
+
+int main(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (i + 1 >= argc) usage(argv[0]);
+    const char *value = argv[++i];
+    if (arg == "--readings") options.readings = atoi(value);
+    else if (arg == "--temp-noise") options.temperatureNoise = atof(value);
+    else if (arg == "--hum-noise") options.humidityNoise = atof(value);
+    else if (arg == "--seed") options.seed = strtoull(value, nullptr, 10);
+    else usage(argv[0]);
+  }
+  if (options.readings < 32) usage(argv[0]);
+
+  printf("Noise per conversion at x1: %.3f C, %.3f %%RH RMS. Chart cells: %.2f C, %.2f %%RH\n",
+         options.temperatureNoise, options.humidityNoise,
+         (LoggerCodec::MAX_TEMP - LoggerCodec::MIN_TEMP) / 255.0, (LoggerCodec::MAX_HUM - LoggerCodec::MIN_HUM) / 255.0);
+  printf("\n%-18s%-9s%10s%10s%9s%10s%10s%9s%9s\n", "profile", "case", "uAs/read", "sensor", "ms/read",
+         "temp sd", "hum sd", "T steps", "H steps");
+  for (int session = 0; session < 2; session++) {
+    for (int p = 0; p < Sensor::PROFILE_COUNT; p++) {
+      Result r = run(options, (Sensor::Profile) p, session);
+      printf("%-18s%-9s%10.1f%10.2f%9.1f%10.4f%10.4f%8.1f%%%8.1f%%\n", NAMES[p], session ? "session" : "wake",
+             r.chargeUas, r.sensorUas, r.ms, r.temperatureSd, r.humiditySd, 100 * r.temperatureSteps,
+             100 * r.humiditySteps);
+    }
+  }
+
+  printf("\nMeasurement wake with the probe attached, sensor ms\n");
+  printf("%-18s%10s%14s%14s\n", "profile", "one", "two together", "one by one");
+  for (int p = 0; p < Sensor::PROFILE_COUNT; p++) {
+    printf("%-18s%10.1f%14.1f%14.1f\n", NAMES[p], pairWakeMs((Sensor::Profile) p, 1, true),
+           pairWakeMs((Sensor::Profile) p, 2, true), pairWakeMs((Sensor::Profile) p, 2, false));
+  }
+  return 0;
+}
@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""
+Decode the per-wake telemetry block (Telemetry::Block) from one or more EEPROM images.
+
+    avrdude -c jtag2updi -p t1614 -P <port> -U eeprom:r:unit1.bin:r
+    telemetry_decode.py unit1.bin unit2.bin ...
+    telemetry_decode.py --csv *.bin > fleet.csv
+"""
+
+import argparse
+import struct
+import sys
+
+TELEMETRY_ADDR = 160  # LoggerCodec::TELEMETRY_ADDR
+FORMAT_ADDR = 254  # LoggerCodec::FORMAT_ADDR, followed by FORMAT_MAGIC and FORMAT_VERSION
+FORMAT_MARKER = bytes([0x4C, 2])
+FORMAT1_TELEMETRY_ADDR = 171  # LoggerCodec::Format1::TELEMETRY_ADDR, units that have not run the page record firmware
+VERSION = 3  # Telemetry::VERSION
+BUCKETS = 6  # Telemetry::BUCKETS
+HEADLESS_BUCKET_SHIFT = 9  # Telemetry::HEADLESS_BUCKET_SHIFT
+SESSION_BUCKET_SHIFT = 12  # Telemetry::SESSION_BUCKET_SHIFT
+
+# Telemetry::Block, packed little-endian as laid out by avr-gcc
+BLOCK = struct.Struct(f"<IBBHH{BUCKETS}H{BUCKETS}HHH")
+FIELDS = ["headless_wakes", "button_wakes", "ready_retries", "sensor_resets", "bus_recoveries", "frames_drawn"]
+
+
+def bucket_labels(shift):
+    labels = [f"<{((1 << i) << shift) / 1000:g}s" for i in range(BUCKETS - 1)]
+    return labels + [f">={((1 << (BUCKETS - 2)) << shift) / 1000:g}s"]
+
+
+def decode(path):
+    with open(path, "rb") as f:
+        image = f.read()
+    if len(image) < FORMAT_ADDR + len(FORMAT_MARKER):
+        raise ValueError(f"image is only {len(image)} bytes")
+    marked = image[FORMAT_ADDR:FORMAT_ADDR + len(FORMAT_MARKER)] == FORMAT_MARKER
+    base = TELEMETRY_ADDR if marked else FORMAT1_TELEMETRY_ADDR
+    values = BLOCK.unpack_from(image, base)
+    if values[1] != VERSION:
+        raise ValueError(f"no telemetry block (version byte {values[1]:#04x})")
+    return {
+        "headless_wakes": values[3],
+        "button_wakes": values[4],
+        "headless_duration": list(values[5:5 + BUCKETS]),
+        "session_duration": list(values[5 + BUCKETS:5 + 2 * BUCKETS]),
+        "ready_retries": values[5 + 2 * BUCKETS],
+        "sensor_resets": values[6 + 2 * BUCKETS],
+        "bus_recoveries": values[2],
+        "frames_drawn": values[0],
+    }
+
+
+def print_block(path, block):
+    print(f"{path}:")
+    for field in FIELDS:
+        print(f"  {field:<18}{block[field]}")
+    for name, shift in (("headless_duration", HEADLESS_BUCKET_SHIFT), ("session_duration", SESSION_BUCKET_SHIFT)):
+        cells = "  ".join(f"{label}:{count}" for label, count in zip(bucket_labels(shift), block[name]))
+        print(f"  {name:<18}{cells}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("images", nargs="+", help="raw EEPROM images (256 bytes)")
+    parser.add_argument("--csv", action="store_true", help="one row per image instead of a readable listing")
+    args = parser.parse_args()
+
+    if args.csv:
+        header = ["unit"] + FIELDS
+        header += [f"headless_{label}" for label in bucket_labels(HEADLESS_BUCKET_SHIFT)]
+        header += [f"session_{label}" for label in bucket_labels(SESSION_BUCKET_SHIFT)]
+        print(",".join(header))
+
+    status = 0
+    for path in args.images:
+        try:
+            block = decode(path)
+        except (OSError, ValueError) as error:
+            print(f"{path}: {error}", file=sys.stderr)
+            status = 1
+            continue
+        if args.csv:
+            row = [path] + [block[field] for field in FIELDS] + block["headless_duration"] + block["session_duration"]
+            print(",".join(str(value) for value in row))
+        else:
+            print_block(path, block)
+    return status
+
+
+if __name__ == "__main__":
+    sys.exit(main())
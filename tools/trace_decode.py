@@ -0,0 +1,74 @@
+#!/usr/bin/env python3
+"""
+Decode the trace summary that the Trace build writes to EEPROM into a timeline.
+
+Read the EEPROM of a unit as a raw image first, e.g. with the programmer used for uploads:
+
+    avrdude -c jtag2updi -p t1614 -P <port> -U eeprom:r:eeprom.bin:r
+    trace_decode.py eeprom.bin
+"""
+
+import argparse
+import os
+import re
+import sys
+
+TRACE_ADDR = 200  # LoggerCodec::TRACE_ADDR
+FORMAT_ADDR = 254  # LoggerCodec::FORMAT_ADDR, followed by FORMAT_MAGIC and FORMAT_VERSION
+FORMAT_MARKER = bytes([0x4C, 2])
+FORMAT1_TRACE_ADDR = 114  # LoggerCodec::Format1::TRACE_ADDR, units that have not run the page record firmware
+EEPROM_ENTRIES = 17  # Trace::EEPROM_ENTRIES
+FORMAT1_EEPROM_ENTRIES = 18
+
+TRACE_H = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "src", "Trace", "Trace.h")
+
+
+def event_names(path):
+    """Read the TraceEvent enum so the decoder always matches the firmware."""
+    with open(path) as f:
+        source = f.read()
+    body = re.search(r"enum TraceEvent : uint8_t \{(.*?)\};", source, re.S).group(1)
+    return [name[len("TRACE_"):] for name in re.findall(r"^\s*(TRACE_\w+)\s*,", body, re.M)]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("image", help="raw EEPROM image (256 bytes)")
+    args = parser.parse_args()
+
+    with open(args.image, "rb") as f:
+        image = f.read()
+    if len(image) < FORMAT_ADDR + len(FORMAT_MARKER):
+        sys.exit(f"{args.image}: image is only {len(image)} bytes")
+    if image[FORMAT_ADDR:FORMAT_ADDR + len(FORMAT_MARKER)] == FORMAT_MARKER:
+        base, entries = TRACE_ADDR, EEPROM_ENTRIES
+    else:
+        base, entries = FORMAT1_TRACE_ADDR, FORMAT1_EEPROM_ENTRIES
+
+    names = event_names(TRACE_H)
+    stored, recorded = image[base], image[base + 1]
+    if stored > entries:
+        sys.exit(f"{args.image}: no trace summary at {base} (entry count {stored})")
+
+    print(f"{recorded}{'+' if recorded == 255 else ''} events this wake, newest {stored} shown")
+    print(f"{'time ms':>9}{'delta':>8}  event")
+    previous = None
+    open_events = {}
+    for i in range(stored):
+        offset = base + 2 + i * 3
+        event = image[offset]
+        ms = image[offset + 1] | image[offset + 2] << 8
+        name = names[event] if event < len(names) else f"unknown({event})"
+        delta = "" if previous is None else f"+{ms - previous}"
+        note = ""
+        if name.endswith("_BEGIN"):
+            open_events[name[:-len("_BEGIN")]] = ms
+        elif name.endswith("_END") and name[:-len("_END")] in open_events:
+            note = f"  ({ms - open_events.pop(name[:-len('_END')])} ms)"
+        print(f"{ms:>9}{delta:>8}  {name}{note}")
+        previous = ms
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
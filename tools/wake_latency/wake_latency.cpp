@@ -0,0 +1,85 @@
+/*
+ * wake_latency: how long a button wake leaves the OLED blank, and when the live reading replaces what it shows.
+ *
+ * Runs the first 2.5 s of a button wake of MainController on the simulated board, in an unchanging environment, and
+ * reports from power on:
+ *   panel on     the SSD1306 is switched on (Display::setup)
+ *   first pixel  the first lit pixel reaches the panel
+ *   live         the last transfer to the panel, which puts up the live reading (later refreshes have nothing new)
+ * and what was sent in that time: whole pages (a full frame is 8) and 8x8 tiles (the stale to live swap).
+ * With samples in the log the first frame is the newest one, marked stale, so the first pixel comes right after the
+ * panel is on instead of after the sensors' start up and first conversion.
+*/
+
+#include <cstdio>
+#include <cstring>
+#include "Arduino.h"
+#include "HostBoard.h"
+#include "Controllers/MainController.h"
+
+namespace {
+
+    constexpr uint8_t PUSH_BUTTON_PIN = 0;           // MainController pins
+    constexpr uint8_t MEASUREMENT_INTERRUPT_PIN = 1;
+    constexpr uint64_t PRESS_US = 100000;            // a short press of the power button
+    constexpr uint64_t PULSE_US = 2000000;           // ATtiny412 FLASH_TIME
+    constexpr uint64_t RUN_US = 2500000;             // past the first refresh at every battery level
+
+    int buttonInputs(uint8_t pin, uint64_t nowUs, void *) {
+      if (pin == PUSH_BUTTON_PIN) return nowUs < PRESS_US ? HIGH : LOW;
+      return pin == MEASUREMENT_INTERRUPT_PIN ? LOW : -1;
+    }
+
+    int pulseInputs(uint8_t pin, uint64_t nowUs, void *) {
+      if (pin == MEASUREMENT_INTERRUPT_PIN) return nowUs < PULSE_US ? HIGH : LOW;
+      return pin == PUSH_BUTTON_PIN ? LOW : -1;
+    }
+
+    /** A measurement wake, which logs one sample. */
+    void logSample() {
+      host::Board &board = host::Board::get();
+      board.powerOn(pulseInputs, nullptr);
+      try {
+        MainController controller;
+        controller.setup();
+      } catch (host::PowerCut &) {
+      }
+    }
+
+    /** The first RUN_US of a button wake. */
+    void buttonWake(const char *name) {
+      host::Board &board = host::Board::get();
+      board.powerOn(buttonInputs, nullptr);
+      MainController controller;
+      controller.setup();
+      while (board.now() < RUN_US) controller.loop();
+
+      printf("%-28s%10.1f%13.1f%9.1f%7u%7u\n", name, board.panelOnUs / 1000.0, board.firstPixelUs / 1000.0,
+             board.lastSentUs / 1000.0, board.pagesSent, board.tilesSent);
+    }
+
+}
+
+int main() {
+  host::Board &board = host::Board::get();
+  memset(board.eeprom, 0xFF, sizeof(board.eeprom));
+
+  printf("%-28s%10s%13s%9s%7s%7s\n", "case", "panel on", "first pixel", "live", "pages", "tiles");
+  board.sensor.setEnvironment(21.0, 45.0);
+  buttonWake("empty log");
+
+  // log a cooler, drier sample, so the live reading differs from the stale one
+  board.sensor.setEnvironment(19.0, 52.0);
+  logSample();
+  board.sensor.setEnvironment(21.0, 45.0);
+  buttonWake("logged sample");
+
+  board.probeAttached = true;
+  board.probe.setEnvironment(4.0, 80.0);
+  buttonWake("logged sample, probe");
+  board.probeAttached = false;
+
+  board.batteryMillivolts = 2700;
+  buttonWake("logged sample, low battery");
+  return 0;
+}